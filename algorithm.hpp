@@ -1,2 +1,4 @@
 #pragma once
-#include <bits/algorithm-heap.hpp>
\ No newline at end of file
+#include <bits/algorithm-heap.hpp>
+#include <bits/algorithm-merge.hpp>
+#include <bits/algorithm-select.hpp>
\ No newline at end of file
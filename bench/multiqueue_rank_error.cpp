@@ -0,0 +1,133 @@
+// Stress benchmark for mystd::multiqueue: measures throughput and rank error for 1, 2, 4, ... up to
+// the hardware thread count.
+//
+//   g++ -std=c++20 -O2 -pthread -I.. multiqueue_rank_error.cpp -o multiqueue_rank_error
+//   ./multiqueue_rank_error [prefill=1000000] [operations=4000000] [max_threads]
+//
+// The queue is prefilled with unique random keys, then P threads each run operations / P random
+// pushes and pops (half each) through push and try_pop. Every operation takes a ticket from a shared
+// counter, pushes before and pops after touching the queue, so each pop is ticketed after the push of
+// its key. Replaying the tickets in order against a Fenwick tree of the keys present gives the rank
+// error of each pop: how many keys still in the queue would have been popped before it by an exact
+// max-queue.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include <bits/multiqueue.hpp>
+
+namespace {
+
+struct event {
+    std::uint64_t ticket;
+    std::uint64_t key;
+    bool pop;
+};
+
+struct fenwick {
+    std::vector<std::int64_t> tree;
+
+    explicit fenwick( std::size_t n ) : tree(n + 1) {}
+
+    void add( std::size_t i, std::int64_t delta ) {
+        for (++i; i < tree.size(); i += i & -i) tree[i] += delta;
+    }
+
+    // Sum over [0, i).
+    std::int64_t prefix( std::size_t i ) const {
+        std::int64_t sum = 0;
+        for (; i > 0; i -= i & -i) sum += tree[i];
+        return sum;
+    }
+};
+
+// Unique key: random high half, thread and sequence number in the low half.
+std::uint64_t make_key( std::mt19937_64& rng, std::uint64_t thread, std::uint64_t seq ) {
+    return (rng() & 0xffffffffu) << 32 | thread << 24 | (seq & 0xffffff);
+}
+
+void run( std::size_t threads, std::size_t prefill, std::size_t operations ) {
+    mystd::multiqueue<std::uint64_t> queue(threads);
+    std::atomic<std::uint64_t> tickets{ 0 };
+    std::vector<std::vector<event>> logs(threads + 1);
+
+    std::mt19937_64 rng(12345);
+    for (std::size_t i = 0; i < prefill; ++i) {
+        std::uint64_t key = make_key(rng, threads, i);
+        logs[threads].push_back({ tickets.fetch_add(1), key, false });
+        queue.push(key);
+    }
+
+    std::atomic<std::size_t> ready{ 0 };
+    std::atomic<bool> start{ false };
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 local(t + 1);
+            std::vector<event>& log = logs[t];
+            std::size_t count = operations / threads;
+            log.reserve(count);
+            ready.fetch_add(1);
+            while (!start.load()) std::this_thread::yield();
+            for (std::size_t i = 0; i < count; ++i) {
+                if (local() & 1) {
+                    std::uint64_t key = make_key(local, t, i);
+                    log.push_back({ tickets.fetch_add(1), key, false });
+                    queue.push(key);
+                } else if (auto key = queue.try_pop()) {
+                    log.push_back({ tickets.fetch_add(1), *key, true });
+                }
+            }
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true);
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<event> events;
+    for (const std::vector<event>& log : logs) events.insert(events.end(), log.begin(), log.end());
+    std::sort(events.begin(), events.end(), []( const event& lhs, const event& rhs ) { return lhs.ticket < rhs.ticket; });
+    std::vector<std::uint64_t> keys;
+    for (const event& e : events) if (!e.pop) keys.push_back(e.key);
+    std::sort(keys.begin(), keys.end());
+
+    fenwick present(keys.size());
+    std::int64_t live = 0;
+    std::uint64_t pops = 0, total_error = 0, max_error = 0;
+    for (const event& e : events) {
+        std::size_t index = static_cast<std::size_t>(std::lower_bound(keys.begin(), keys.end(), e.key) - keys.begin());
+        if (!e.pop) {
+            present.add(index, 1);
+            ++live;
+            continue;
+        }
+        std::uint64_t error = static_cast<std::uint64_t>(live - present.prefix(index + 1));
+        present.add(index, -1);
+        --live;
+        ++pops;
+        total_error += error;
+        max_error = std::max(max_error, error);
+    }
+
+    std::size_t performed = operations / threads * threads;
+    std::printf("%7zu %12.2f %14.2f %12.2f %10llu\n", threads, performed / seconds / 1e6, performed / seconds / 1e6 / threads,
+                pops ? static_cast<double>(total_error) / pops : 0.0, static_cast<unsigned long long>(max_error));
+}
+
+} // namespace
+
+int main( int argc, char** argv ) {
+    std::size_t prefill = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t operations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+    std::size_t max_threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    std::printf("threads   total Mops/s  Mops/s/thread  mean error  max error\n");
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) run(threads, prefill, operations);
+}
@@ -1,156 +1,260 @@
 #pragma once // algorithm-heap.hpp
 
+#ifndef _MYSTD_HEAP_BLOCK_BYTES
+#define _MYSTD_HEAP_BLOCK_BYTES 262144
+#endif
+
+#ifndef _MYSTD_PARALLEL_GRAIN
+#define _MYSTD_PARALLEL_GRAIN 16384
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <concepts>
 #include <cstddef>
 #include <execution>
 #include <functional>
 #include <iterator>
+#include <thread>
 #include <type_traits>
+#include <vector>
+#include "heap-simd.hpp"
+#include "heap-stats.hpp"
 
 namespace mystd {
 
+template< std::random_access_iterator It, class Comp >
+constexpr void __push_heap_hole( It first, typename std::iterator_traits<It>::difference_type hole, typename std::iterator_traits<It>::difference_type top, typename std::iterator_traits<It>::value_type value, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    diff_t levels = 0;
+    diff_t parent = ( hole - 1 ) / 2;
+    while ( hole > top && comp( *( first + parent ), value ) ) {
+        *( first + hole ) = std::move( *( first + parent ) );
+        hole = parent;
+        parent = ( hole - 1 ) / 2;
+        ++levels;
+    }
+    *( first + hole ) = std::move( value );
+    mystd::__heap_note_moves( comp, levels + 1 );
+    mystd::__heap_note_sift( comp, false, levels );
+}
+
+// Bottom-up (Floyd) sift: walk the hole down to a leaf along the larger child, one comparison
+// per level, then sift value back up from there. Elements are moved into the hole, never swapped.
+template< std::random_access_iterator It, class Comp >
+constexpr void __adjust_heap( It first, typename std::iterator_traits<It>::difference_type hole, typename std::iterator_traits<It>::difference_type size, typename std::iterator_traits<It>::value_type value, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t top = hole;
+    diff_t levels = 0;
+    diff_t child = hole;
+    while ( child < ( size - 1 ) / 2 ) {
+        child = 2 * child + 2;
+        if ( comp( *( first + child ), *( first + ( child - 1 ) ) ) ) {
+            --child;
+        }
+        *( first + hole ) = std::move( *( first + child ) );
+        hole = child;
+        ++levels;
+    }
+    if ( ( size & 1 ) == 0 && child == ( size - 2 ) / 2 ) {
+        child = 2 * child + 1;
+        *( first + hole ) = std::move( *( first + child ) );
+        hole = child;
+        ++levels;
+    }
+    mystd::__heap_note_moves( comp, levels );
+    mystd::__heap_note_sift( comp, true, levels );
+    mystd::__push_heap_hole( first, hole, top, std::move( value ), comp );
+}
+
 template< std::random_access_iterator It >
 requires std::is_swappable_v<It> && std::is_move_constructible_v<It> && std::is_move_assignable_v<It>
 constexpr void push_heap( It first, It last ) {
-    using diff_t = typename std::iterator_traits<It>::difference_type;
-    diff_t index = ( last - first ) - 1;
-    while ( index > 0 ) {
-        diff_t parent = ( index - 1 ) / 2;
-        if ( std::less<>{}( *( first + parent ), *( first + index ) ) ) {
-            std::iter_swap( first + parent, first + index );
-            index = parent;
-        } else {
-            break;
-        }
+    std::less<> comp;
+    if ( last - first > 1 ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+        mystd::__push_heap_hole( first, ( last - first ) - 1, 0, std::move( value ), comp );
     }
 }
 
 template< std::random_access_iterator It, class Comp >
 requires std::predicate< Comp, const typename std::iterator_traits<It>::reference, const typename std::iterator_traits<It>::reference >
 constexpr void push_heap( It first, It last, Comp comp ) {
-    using diff_t = typename std::iterator_traits<It>::difference_type;
-    diff_t index = ( last - first ) - 1;
-    while ( index > 0 ) {
-        diff_t parent = ( index - 1 ) / 2;
-        if ( comp( *( first + parent ), *( first + index ) ) ) {
-            std::iter_swap( first + parent, first + index );
-            index = parent;
-        } else {
-            break;
-        }
+    if ( last - first > 1 ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+        mystd::__push_heap_hole( first, ( last - first ) - 1, 0, std::move( value ), comp );
     }
 }
 
 template< std::random_access_iterator It >
 requires std::is_swappable_v<It> && std::is_move_constructible_v<It> && std::is_move_assignable_v<It>
 constexpr void pop_heap( It first, It last ) {
-    using diff_t = typename std::iterator_traits<It>::difference_type;
+    std::less<> comp;
     if ( last - first <= 1 ) {
         return;
     }
-    std::iter_swap( first, last - 1 );
-    diff_t size = ( last - first ) - 1;
-    diff_t index = 0;
-    while ( true ) {
-        diff_t left = 2 * index + 1;
-        diff_t right = 2 * index + 2;
-        diff_t largest = index;
-        if ( left < size && std::less<>{}( *( first + largest ), *( first + left ) ) ) {
-            largest = left;
-        }
-        if ( right < size && std::less<>{}( *( first + largest ), *( first + right ) ) ) {
-            largest = right;
-        }
-        if ( largest != index ) {
-            std::iter_swap( first + index, first + largest );
-            index = largest;
-        } else {
-            break;
-        }
-    }
+    typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+    *( last - 1 ) = std::move( *first );
+    mystd::__heap_note_moves( comp, 2 );
+    mystd::__adjust_heap( first, 0, ( last - first ) - 1, std::move( value ), comp );
 }
 
 template< std::random_access_iterator It, class Comp >
 requires std::predicate< Comp, const typename std::iterator_traits<It>::reference, const typename std::iterator_traits<It>::reference >
 constexpr void pop_heap( It first, It last, Comp comp ) {
-    using diff_t = typename std::iterator_traits<It>::difference_type;
     if ( last - first <= 1 ) {
         return;
     }
-    std::iter_swap( first, last - 1 );
-    diff_t size = ( last - first ) - 1;
-    diff_t index = 0;
-    while ( true ) {
-        diff_t left = 2 * index + 1;
-        diff_t right = 2 * index + 2;
-        diff_t largest = index;
-        if ( left < size && comp( *( first + largest ), *( first + left ) ) ) {
-            largest = left;
+    typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+    *( last - 1 ) = std::move( *first );
+    mystd::__heap_note_moves( comp, 2 );
+    mystd::__adjust_heap( first, 0, ( last - first ) - 1, std::move( value ), comp );
+}
+
+// Number of levels of a subtree that fits in _MYSTD_HEAP_BLOCK_BYTES, at least one.
+template< class T >
+constexpr int __heap_block_height() {
+    int height = 1;
+    while ( height < 62 && ( ( std::size_t( 1 ) << ( height + 1 ) ) - 1 ) * sizeof( T ) <= _MYSTD_HEAP_BLOCK_BYTES ) {
+        ++height;
+    }
+    return height;
+}
+
+// Floyd construction of the subtree rooted at root (on level root_level), bottom level first.
+template< std::random_access_iterator It, class Comp >
+constexpr void __heapify_subtree( It first, typename std::iterator_traits<It>::difference_type root, int root_level, int depth, typename std::iterator_traits<It>::difference_type size, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t parents = size / 2;
+    for ( int level = depth - 1; level >= root_level; --level ) {
+        diff_t begin = ( ( root + 1 ) << ( level - root_level ) ) - 1;
+        if ( begin >= parents ) {
+            continue;
         }
-        if ( right < size && comp( *( first + largest ), *( first + right ) ) ) {
-            largest = right;
+        diff_t end = std::min( begin + ( diff_t( 1 ) << ( level - root_level ) ), parents );
+        for ( diff_t i = end; i-- > begin; ) {
+            typename std::iterator_traits<It>::value_type value = std::move( *( first + i ) );
+            mystd::__adjust_heap( first, i, size, std::move( value ), comp );
         }
-        if ( largest != index ) {
-            std::iter_swap( first + index, first + largest );
-            index = largest;
-        } else {
-            break;
+    }
+}
+
+// Ranges larger than _MYSTD_HEAP_BLOCK_BYTES are built subtree by subtree, each subtree small
+// enough to stay in cache, before the levels above them are merged in.
+template< std::random_access_iterator It, class Comp >
+constexpr void __make_heap( It first, It last, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t size = last - first;
+    if ( size < 2 ) {
+        return;
+    }
+    const int depth = std::bit_width( static_cast<std::make_unsigned_t<diff_t>>( size ) );
+    const int block = mystd::__heap_block_height<typename std::iterator_traits<It>::value_type>();
+    diff_t top = size / 2;
+    if ( depth > block ) {
+        const int root_level = depth - block;
+        top = ( diff_t( 1 ) << root_level ) - 1;
+        for ( diff_t root = std::min( 2 * top + 1, size ); root-- > top; ) {
+            mystd::__heapify_subtree( first, root, root_level, depth, size, comp );
         }
     }
+    for ( diff_t i = std::min( top, size / 2 ); i-- > 0; ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( first + i ) );
+        mystd::__adjust_heap( first, i, size, std::move( value ), comp );
+    }
 }
 
 template< std::random_access_iterator It >
 requires std::is_swappable_v<It> && std::is_move_constructible_v<It> && std::is_move_assignable_v<It>
 constexpr void make_heap( It first, It last ) {
-    using diff_t = typename std::iterator_traits<It>::difference_type;
-    std::function<void(It, It, diff_t)> heapify = [&heapify]( It start, It end, diff_t root ) {
-        diff_t size = end - start;
-        diff_t largest = root;
-        diff_t left = 2 * root + 1;
-        diff_t right = 2 * root + 2;
-        if ( left < size && std::less<>{}( *( start + largest ), *( start + left ) ) ) {
-            largest = left;
-        }
-        if ( right < size && std::less<>{}( *( start + largest ), *( start + right ) ) ) {
-            largest = right;
-        }
-        if ( largest != root ) {
-            std::iter_swap( start + root, start + largest );
-            heapify( start, end, largest );
-        }
-    };
-    diff_t size = last - first;
-    for ( diff_t i = size / 2 - 1; i-- > 0; ) {
-        heapify( first, last, i );
-    }
+    std::less<> comp;
+    mystd::__make_heap( first, last, comp );
 }
 
 template< std::random_access_iterator It, class Comp >
 requires std::predicate< Comp, const typename std::iterator_traits<It>::reference, const typename std::iterator_traits<It>::reference >
 constexpr void make_heap( It first, It last, Comp comp ) {
+    mystd::__make_heap( first, last, comp );
+}
+
+template< class ExecutionPolicy >
+inline constexpr bool __is_parallel_policy_v = std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_policy> || std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_unsequenced_policy>;
+
+// Worker count for a parallel pass over size elements, one per _MYSTD_PARALLEL_GRAIN at most.
+inline unsigned __parallel_workers( std::ptrdiff_t size ) {
+    unsigned workers = std::max( std::thread::hardware_concurrency(), 1u );
+    std::ptrdiff_t grains = size / _MYSTD_PARALLEL_GRAIN;
+    return grains < std::ptrdiff_t( workers ) ? unsigned( std::max( grains, std::ptrdiff_t( 1 ) ) ) : workers;
+}
+
+// Splits [0, count) into workers contiguous chunks and runs fn( begin, end ) on each, the first on the calling thread.
+template< class Fn >
+void __parallel_for( unsigned workers, std::ptrdiff_t count, Fn fn ) {
+    if ( workers <= 1 || count <= 1 ) {
+        fn( std::ptrdiff_t( 0 ), count );
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve( workers - 1 );
+    for ( unsigned w = 1; w < workers; ++w ) {
+        threads.emplace_back( fn, count * w / workers, count * ( w + 1 ) / workers );
+    }
+    fn( std::ptrdiff_t( 0 ), count / workers );
+    for ( std::thread& t : threads ) {
+        t.join();
+    }
+}
+
+// Subtrees below the root level are heapified concurrently, then each level above is sifted
+// in parallel; sifts on one level touch disjoint subtrees.
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+void __make_heap( ExecutionPolicy&&, It first, It last, Comp& comp ) {
     using diff_t = typename std::iterator_traits<It>::difference_type;
-    std::function<void(It, It, diff_t)> heapify = [&heapify, &comp]( It start, It end, diff_t root ) {
-        diff_t size = end - start;
-        diff_t largest = root;
-        diff_t left = 2 * root + 1;
-        diff_t right = 2 * root + 2;
-        if ( left < size && comp( *( start + largest ), *( start + left ) ) ) {
-            largest = left;
-        }
-        if ( right < size && comp( *( start + largest ), *( start + right ) ) ) {
-            largest = right;
+    const diff_t size = last - first;
+    const unsigned workers = mystd::__parallel_workers( size );
+    const int depth = std::bit_width( static_cast<std::make_unsigned_t<diff_t>>( size ) );
+    const int root_level = std::max( depth - mystd::__heap_block_height<typename std::iterator_traits<It>::value_type>(), int( std::bit_width( 4u * workers ) ) );
+    if ( !__is_parallel_policy_v<ExecutionPolicy> || workers <= 1 || root_level >= depth ) {
+        mystd::__make_heap( first, last, comp );
+        return;
+    }
+    const diff_t top = ( diff_t( 1 ) << root_level ) - 1;
+    mystd::__parallel_for( workers, std::min( 2 * top + 1, size ) - top, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+        for ( diff_t root = top + end; root-- > top + begin; ) {
+            mystd::__heapify_subtree( first, root, root_level, depth, size, comp );
         }
-        if ( largest != root ) {
-            std::iter_swap( start + root, start + largest );
-            heapify( start, end, largest );
+    } );
+    for ( int level = root_level - 1; level >= 0; --level ) {
+        const diff_t begin = ( diff_t( 1 ) << level ) - 1;
+        const diff_t end = std::min( 2 * begin + 1, size / 2 );
+        auto sift = [&]( std::ptrdiff_t from, std::ptrdiff_t to ) {
+            for ( diff_t i = begin + to; i-- > begin + from; ) {
+                typename std::iterator_traits<It>::value_type value = std::move( *( first + i ) );
+                mystd::__adjust_heap( first, i, size, std::move( value ), comp );
+            }
+        };
+        if ( end - begin >= 4 * diff_t( workers ) ) {
+            mystd::__parallel_for( workers, end - begin, sift );
+        } else {
+            sift( 0, end - begin );
         }
-    };
-    diff_t size = last - first;
-    for ( diff_t i = size / 2 - 1; i-- > 0; ) {
-        heapify( first, last, i );
     }
 }
 
+template< class ExecutionPolicy, std::random_access_iterator It >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void make_heap( ExecutionPolicy&& policy, It first, It last ) {
+    std::less<> comp;
+    mystd::__make_heap( std::forward<ExecutionPolicy>( policy ), first, last, comp );
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void make_heap( ExecutionPolicy&& policy, It first, It last, Comp comp ) {
+    mystd::__make_heap( std::forward<ExecutionPolicy>( policy ), first, last, comp );
+}
+
 template< std::random_access_iterator It >
 constexpr void sort_heap( It first, It last ) {
     while ( last - first > 1 ) {
@@ -167,6 +271,49 @@ constexpr void sort_heap( It first, It last, Comp comp ) {
     }
 }
 
+// A sorted heap is a sorted range, so the parallel form sorts chunks and merges them pairwise.
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+void __sort_heap( ExecutionPolicy&&, It first, It last, Comp& comp ) {
+    const std::ptrdiff_t size = last - first;
+    const unsigned workers = mystd::__parallel_workers( size );
+    if ( !__is_parallel_policy_v<ExecutionPolicy> || workers <= 1 ) {
+        mystd::sort_heap( first, last, comp );
+        return;
+    }
+    auto bound = [&]( std::ptrdiff_t chunk ) { return first + size * chunk / workers; };
+    mystd::__parallel_for( workers, workers, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+        for ( std::ptrdiff_t chunk = begin; chunk < end; ++chunk ) {
+            std::sort( bound( chunk ), bound( chunk + 1 ), comp );
+        }
+    } );
+    for ( std::ptrdiff_t width = 1; width < workers; width *= 2 ) {
+        const std::ptrdiff_t merges = ( workers + 2 * width - 1 ) / ( 2 * width );
+        mystd::__parallel_for( unsigned( merges ), merges, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+            for ( std::ptrdiff_t m = begin; m < end; ++m ) {
+                std::ptrdiff_t lo = 2 * width * m;
+                std::ptrdiff_t mid = std::min<std::ptrdiff_t>( lo + width, workers );
+                std::ptrdiff_t hi = std::min<std::ptrdiff_t>( lo + 2 * width, workers );
+                if ( mid < hi ) {
+                    std::inplace_merge( bound( lo ), bound( mid ), bound( hi ), comp );
+                }
+            }
+        } );
+    }
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void sort_heap( ExecutionPolicy&& policy, It first, It last ) {
+    std::less<> comp;
+    mystd::__sort_heap( std::forward<ExecutionPolicy>( policy ), first, last, comp );
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void sort_heap( ExecutionPolicy&& policy, It first, It last, Comp comp ) {
+    mystd::__sort_heap( std::forward<ExecutionPolicy>( policy ), first, last, comp );
+}
+
 template< std::random_access_iterator It >
 constexpr bool is_heap( It first, It last ) {
     using diff_t = typename std::iterator_traits<It>::difference_type;
@@ -184,12 +331,6 @@ constexpr bool is_heap( It first, It last ) {
     return true;
 }
 
-template< class ExecutionPolicy, std::random_access_iterator It >
-requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
-bool is_heap( ExecutionPolicy&& policy, It first, It last ) {
-    return is_heap( first, last );
-}
-
 template< std::random_access_iterator It, class Comp >
 constexpr bool is_heap( It first, It last, Comp comp ) {
     using diff_t = typename std::iterator_traits<It>::difference_type;
@@ -207,12 +348,6 @@ constexpr bool is_heap( It first, It last, Comp comp ) {
     return true;
 }
 
-template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
-requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
-bool is_heap( ExecutionPolicy&& policy, It first, It last, Comp comp ) {
-    return is_heap( first, last, comp );
-}
-
 template< std::random_access_iterator It >
 constexpr It is_heap_until( It first, It last ) {
     using diff_t = typename std::iterator_traits<It>::difference_type;
@@ -230,12 +365,6 @@ constexpr It is_heap_until( It first, It last ) {
     return last;
 }
 
-template< class ExecutionPolicy, std::random_access_iterator It >
-requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
-It is_heap_until( ExecutionPolicy&& policy, It first, It last ) {
-    return is_heap_until( first, last );
-}
-
 template< std::random_access_iterator It, class Comp >
 constexpr It is_heap_until( It first, It last, Comp comp ) {
     using diff_t = typename std::iterator_traits<It>::difference_type;
@@ -253,11 +382,236 @@ constexpr It is_heap_until( It first, It last, Comp comp ) {
     return last;
 }
 
+// Each worker scans a contiguous run of parents; violations are reported as the offending child
+// index, so the earliest one overall is the minimum, and workers stop once past it.
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+It __is_heap_until( ExecutionPolicy&&, It first, It last, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t size = last - first;
+    const unsigned workers = mystd::__parallel_workers( size );
+    if ( !__is_parallel_policy_v<ExecutionPolicy> || workers <= 1 ) {
+        return mystd::is_heap_until( first, last, comp );
+    }
+    std::atomic<diff_t> found{ size };
+    auto report = [&found]( diff_t child ) {
+        diff_t current = found.load( std::memory_order_relaxed );
+        while ( child < current && !found.compare_exchange_weak( current, child, std::memory_order_relaxed ) ) {}
+    };
+    mystd::__parallel_for( workers, size / 2, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+        for ( diff_t i = begin; i < end; ++i ) {
+            diff_t left = 2 * i + 1;
+            diff_t right = 2 * i + 2;
+            if ( left >= found.load( std::memory_order_relaxed ) ) {
+                return;
+            }
+            if ( comp( *( first + i ), *( first + left ) ) ) {
+                report( left );
+                return;
+            }
+            if ( right < size && comp( *( first + i ), *( first + right ) ) ) {
+                report( right );
+                return;
+            }
+        }
+    } );
+    return first + found.load();
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+bool is_heap( ExecutionPolicy&& policy, It first, It last ) {
+    std::less<> comp;
+    return mystd::__is_heap_until( std::forward<ExecutionPolicy>( policy ), first, last, comp ) == last;
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+bool is_heap( ExecutionPolicy&& policy, It first, It last, Comp comp ) {
+    return mystd::__is_heap_until( std::forward<ExecutionPolicy>( policy ), first, last, comp ) == last;
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+It is_heap_until( ExecutionPolicy&& policy, It first, It last ) {
+    std::less<> comp;
+    return mystd::__is_heap_until( std::forward<ExecutionPolicy>( policy ), first, last, comp );
+}
+
 template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
 requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
 It is_heap_until( ExecutionPolicy&& policy, It first, It last, Comp comp ) {
-    return is_heap_until( first, last, comp );
+    return mystd::__is_heap_until( std::forward<ExecutionPolicy>( policy ), first, last, comp );
 }
 
-} // namespace mystd
+// d-ary heaps: the children of index i are Arity * i + 1 ... Arity * i + Arity. Selected with an
+// explicit first template argument, e.g. mystd::push_heap<4>( first, last, comp ); Arity 2 forwards
+// to the binary algorithms above.
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp >
+constexpr void __dary_push_heap_hole( It first, typename std::iterator_traits<It>::difference_type hole, typename std::iterator_traits<It>::difference_type top, typename std::iterator_traits<It>::value_type value, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    diff_t levels = 0;
+    while ( hole > top ) {
+        diff_t parent = ( hole - 1 ) / diff_t( Arity );
+        if ( !comp( *( first + parent ), value ) ) {
+            break;
+        }
+        *( first + hole ) = std::move( *( first + parent ) );
+        hole = parent;
+        ++levels;
+    }
+    *( first + hole ) = std::move( value );
+    mystd::__heap_note_moves( comp, levels + 1 );
+    mystd::__heap_note_sift( comp, false, levels );
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp >
+constexpr typename std::iterator_traits<It>::difference_type __dary_best_child( It first, typename std::iterator_traits<It>::difference_type child, typename std::iterator_traits<It>::difference_type size, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    if constexpr ( mystd::__simd_heap_eligible<Arity, It, Comp>() ) {
+        if ( !std::is_constant_evaluated() && size - child >= diff_t( Arity ) ) {
+            using T = std::remove_cv_t<typename std::iterator_traits<It>::value_type>;
+            return child + diff_t( mystd::__simd_best_child<Arity, __is_less_compare_v<Comp, T>>( std::to_address( first + child ) ) );
+        }
+    }
+    diff_t best = child;
+    diff_t end = size - child >= diff_t( Arity ) ? child + diff_t( Arity ) : size;
+    for ( diff_t i = child + 1; i < end; ++i ) {
+        if ( comp( *( first + best ), *( first + i ) ) ) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp >
+constexpr void __dary_adjust_heap( It first, typename std::iterator_traits<It>::difference_type hole, typename std::iterator_traits<It>::difference_type size, typename std::iterator_traits<It>::value_type value, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t top = hole;
+    diff_t levels = 0;
+    for ( diff_t child = diff_t( Arity ) * hole + 1; child < size; child = diff_t( Arity ) * hole + 1 ) {
+        diff_t best = mystd::__dary_best_child<Arity>( first, child, size, comp );
+        *( first + hole ) = std::move( *( first + best ) );
+        hole = best;
+        ++levels;
+    }
+    mystd::__heap_note_moves( comp, levels );
+    mystd::__heap_note_sift( comp, true, levels );
+    mystd::__dary_push_heap_hole<Arity>( first, hole, top, std::move( value ), comp );
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr void push_heap( It first, It last, Comp comp = Comp() ) {
+    if constexpr ( Arity == 2 ) {
+        mystd::push_heap( first, last, comp );
+    } else if ( last - first > 1 ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+        mystd::__dary_push_heap_hole<Arity>( first, ( last - first ) - 1, 0, std::move( value ), comp );
+    }
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr void pop_heap( It first, It last, Comp comp = Comp() ) {
+    if constexpr ( Arity == 2 ) {
+        mystd::pop_heap( first, last, comp );
+    } else if ( last - first > 1 ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( last - 1 ) );
+        *( last - 1 ) = std::move( *first );
+        mystd::__heap_note_moves( comp, 2 );
+        mystd::__dary_adjust_heap<Arity>( first, 0, ( last - first ) - 1, std::move( value ), comp );
+    }
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr void make_heap( It first, It last, Comp comp = Comp() ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    if constexpr ( Arity == 2 ) {
+        mystd::make_heap( first, last, comp );
+    } else if ( last - first > 1 ) {
+        const diff_t size = last - first;
+        for ( diff_t i = ( size - 2 ) / diff_t( Arity ) + 1; i-- > 0; ) {
+            typename std::iterator_traits<It>::value_type value = std::move( *( first + i ) );
+            mystd::__dary_adjust_heap<Arity>( first, i, size, std::move( value ), comp );
+        }
+    }
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr void sort_heap( It first, It last, Comp comp = Comp() ) {
+    while ( last - first > 1 ) {
+        mystd::pop_heap<Arity>( first, last, comp );
+        --last;
+    }
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr It is_heap_until( It first, It last, Comp comp = Comp() ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    diff_t size = last - first;
+    for ( diff_t i = 1; i < size; ++i ) {
+        if ( comp( *( first + ( i - 1 ) / diff_t( Arity ) ), *( first + i ) ) ) {
+            return first + i;
+        }
+    }
+    return last;
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp = std::less<> >
+requires ( Arity >= 2 )
+constexpr bool is_heap( It first, It last, Comp comp = Comp() ) {
+    return mystd::is_heap_until<Arity>( first, last, comp ) == last;
+}
+
+// Instrumented overloads: the trailing Stats& (heap_stats, or no_heap_stats to compile the
+// counting out) records comparisons, moves, sift depth and the latency of the call.
+
+template< std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+void push_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::push, comp, [&]( auto& c ) { mystd::push_heap( first, last, c ); } );
+}
+
+template< std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+void pop_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::pop, comp, [&]( auto& c ) { mystd::pop_heap( first, last, c ); } );
+}
+
+template< std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+void make_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::make, comp, [&]( auto& c ) { mystd::make_heap( first, last, c ); } );
+}
+
+template< std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+void sort_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::sort, comp, [&]( auto& c ) { mystd::sort_heap( first, last, c ); } );
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+requires ( Arity >= 2 )
+void push_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::push, comp, [&]( auto& c ) { mystd::push_heap<Arity>( first, last, c ); } );
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+requires ( Arity >= 2 )
+void pop_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::pop, comp, [&]( auto& c ) { mystd::pop_heap<Arity>( first, last, c ); } );
+}
+
+template< std::size_t Arity, std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+requires ( Arity >= 2 )
+void make_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::make, comp, [&]( auto& c ) { mystd::make_heap<Arity>( first, last, c ); } );
+}
 
+template< std::size_t Arity, std::random_access_iterator It, class Comp, __heap_stats_policy Stats >
+requires ( Arity >= 2 )
+void sort_heap( It first, It last, Comp comp, Stats& stats ) {
+    mystd::__instrumented( stats, heap_op::sort, comp, [&]( auto& c ) { mystd::sort_heap<Arity>( first, last, c ); } );
+}
+
+} // namespace mystd
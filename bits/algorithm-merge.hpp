@@ -0,0 +1,105 @@
+#pragma once // algorithm-merge.hpp
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mystd {
+
+template< class R >
+concept __merge_source = std::ranges::input_range<R> && ( std::is_lvalue_reference_v<R> || std::ranges::borrowed_range<R> );
+
+// Tournament (loser) tree over k cursors: node 0 holds the overall winner, nodes 1..k-1 the loser
+// of the match played there, and leaf k + i stands for source i. Replacing the winner replays only
+// its path to the root, one comparison per level. An exhausted source loses every match, and a tie
+// goes to the lower source index, which keeps the merge stable.
+template< bool Move, class Cursors, class Out, class Comp, class Proj >
+constexpr Out __merge_k_tree( Cursors& src, Out out, Comp& comp, Proj& proj ) {
+    const std::size_t k = src.size();
+    if ( k == 0 ) {
+        return out;
+    }
+    auto beats = [ &src, &comp, &proj ]( std::size_t a, std::size_t b ) {
+        if ( src[ b ].first == src[ b ].second ) {
+            return true;
+        }
+        if ( src[ a ].first == src[ a ].second ) {
+            return false;
+        }
+        if ( a < b ) {
+            return !std::invoke( comp, std::invoke( proj, *src[ b ].first ), std::invoke( proj, *src[ a ].first ) );
+        }
+        return static_cast<bool>( std::invoke( comp, std::invoke( proj, *src[ a ].first ), std::invoke( proj, *src[ b ].first ) ) );
+    };
+    std::vector<std::size_t> tree( k );
+    std::vector<std::size_t> winner( k );
+    for ( std::size_t node = k; node-- > 1; ) {
+        std::size_t left = 2 * node < k ? winner[ 2 * node ] : 2 * node - k;
+        std::size_t right = 2 * node + 1 < k ? winner[ 2 * node + 1 ] : 2 * node + 1 - k;
+        if ( beats( left, right ) ) {
+            winner[ node ] = left;
+            tree[ node ] = right;
+        } else {
+            winner[ node ] = right;
+            tree[ node ] = left;
+        }
+    }
+    tree[ 0 ] = k == 1 ? 0 : winner[ 1 ];
+    while ( true ) {
+        std::size_t w = tree[ 0 ];
+        auto& cur = src[ w ];
+        if ( cur.first == cur.second ) {
+            return out;
+        }
+        if constexpr ( Move ) {
+            *out = std::ranges::iter_move( cur.first );
+        } else {
+            *out = *cur.first;
+        }
+        ++out;
+        ++cur.first;
+        for ( std::size_t node = ( k + w ) / 2; node > 0; node /= 2 ) {
+            if ( beats( tree[ node ], w ) ) {
+                std::swap( tree[ node ], w );
+            }
+        }
+        tree[ 0 ] = w;
+    }
+}
+
+template< bool Move, std::ranges::input_range R, class Out, class Comp, class Proj >
+constexpr Out __merge_k( R&& ranges, Out out, Comp& comp, Proj& proj ) {
+    using inner_t = std::ranges::range_reference_t<R>;
+    std::vector<std::pair<std::ranges::iterator_t<inner_t>, std::ranges::sentinel_t<inner_t>>> src;
+    if constexpr ( std::ranges::sized_range<R> ) {
+        src.reserve( std::ranges::size( ranges ) );
+    }
+    for ( auto&& r : ranges ) {
+        src.emplace_back( std::ranges::begin( r ), std::ranges::end( r ) );
+    }
+    return mystd::__merge_k_tree<Move>( src, std::move( out ), comp, proj );
+}
+
+// Merges k sorted ranges into out in O(n log k) comparisons. Equal elements keep the order of
+// their sources, so the result is the same as a stable sort of the concatenated inputs.
+template< std::ranges::input_range R, std::weakly_incrementable Out, class Comp = std::ranges::less, class Proj = std::identity >
+requires __merge_source<std::ranges::range_reference_t<R>> && std::indirectly_copyable<std::ranges::iterator_t<std::ranges::range_reference_t<R>>, Out>
+      && std::indirect_strict_weak_order<Comp, std::projected<std::ranges::iterator_t<std::ranges::range_reference_t<R>>, Proj>>
+constexpr Out merge_k( R&& ranges, Out out, Comp comp = {}, Proj proj = {} ) {
+    return mystd::__merge_k<false>( std::forward<R>( ranges ), std::move( out ), comp, proj );
+}
+
+// As merge_k, but moves the elements out of the input ranges.
+template< std::ranges::input_range R, std::weakly_incrementable Out, class Comp = std::ranges::less, class Proj = std::identity >
+requires __merge_source<std::ranges::range_reference_t<R>> && std::indirectly_movable<std::ranges::iterator_t<std::ranges::range_reference_t<R>>, Out>
+      && std::indirect_strict_weak_order<Comp, std::projected<std::ranges::iterator_t<std::ranges::range_reference_t<R>>, Proj>>
+constexpr Out merge_k_move( R&& ranges, Out out, Comp comp = {}, Proj proj = {} ) {
+    return mystd::__merge_k<true>( std::forward<R>( ranges ), std::move( out ), comp, proj );
+}
+
+} // namespace mystd
@@ -0,0 +1,307 @@
+#pragma once // algorithm-select.hpp
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algorithm-heap.hpp"
+
+namespace mystd {
+
+template< class Comp, class Proj >
+struct __projected_compare {
+    Comp& comp;
+    Proj& proj;
+
+    template< class L, class R >
+    constexpr bool operator()( L&& lhs, R&& rhs ) const {
+        return std::invoke( comp, std::invoke( proj, std::forward<L>( lhs ) ), std::invoke( proj, std::forward<R>( rhs ) ) );
+    }
+};
+
+template< class Comp >
+struct __inverted_compare {
+    Comp& comp;
+
+    template< class L, class R >
+    constexpr bool operator()( L&& lhs, R&& rhs ) const {
+        return comp( std::forward<R>( rhs ), std::forward<L>( lhs ) );
+    }
+};
+
+// Leaves the middle - first smallest elements of [first, last) in [first, middle) as a heap, so
+// *first is the largest of them. Each of the n - k remaining elements costs one comparison, plus
+// a sift of O(log k) when it displaces the top.
+template< std::random_access_iterator It, class Comp >
+constexpr void __heap_select( It first, It middle, It last, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t k = middle - first;
+    if ( k == 0 ) {
+        return;
+    }
+    mystd::__make_heap( first, middle, comp );
+    for ( It it = middle; it != last; ++it ) {
+        if ( comp( *it, *first ) ) {
+            typename std::iterator_traits<It>::value_type value = std::move( *it );
+            *it = std::move( *first );
+            mystd::__adjust_heap( first, diff_t( 0 ), k, std::move( value ), comp );
+        }
+    }
+}
+
+// Copies the k smallest elements of [first, last) into buf, arranged as a heap.
+template< std::input_iterator It, class T, class Comp >
+constexpr void __heap_select_copy( It first, It last, std::size_t k, std::vector<T>& buf, Comp& comp ) {
+    buf.reserve( buf.size() + k );
+    const std::size_t base = buf.size();
+    for ( ; first != last && buf.size() - base < k; ++first ) {
+        buf.push_back( *first );
+    }
+    const std::ptrdiff_t size = std::ptrdiff_t( buf.size() - base );
+    if ( size == 0 ) {
+        return;
+    }
+    auto top = buf.begin() + base;
+    mystd::__make_heap( top, buf.end(), comp );
+    for ( ; first != last; ++first ) {
+        if ( comp( *first, *top ) ) {
+            mystd::__adjust_heap( top, std::ptrdiff_t( 0 ), size, T( *first ), comp );
+        }
+    }
+}
+
+template< std::random_access_iterator It, class Comp >
+constexpr void __partial_sort( It first, It middle, It last, Comp& comp ) {
+    mystd::__heap_select( first, middle, last, comp );
+    while ( middle - first > 1 ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *( middle - 1 ) );
+        *( middle - 1 ) = std::move( *first );
+        --middle;
+        mystd::__adjust_heap( first, typename std::iterator_traits<It>::difference_type( 0 ), middle - first, std::move( value ), comp );
+    }
+}
+
+template< std::random_access_iterator It, class Comp >
+constexpr void __insertion_sort( It first, It last, Comp& comp ) {
+    for ( It i = first; i != last; ++i ) {
+        typename std::iterator_traits<It>::value_type value = std::move( *i );
+        It hole = i;
+        for ( ; hole != first && comp( value, *( hole - 1 ) ); --hole ) {
+            *hole = std::move( *( hole - 1 ) );
+        }
+        *hole = std::move( value );
+    }
+}
+
+template< std::random_access_iterator It, class Comp >
+constexpr void __move_median_to_first( It result, It a, It b, It c, Comp& comp ) {
+    if ( comp( *a, *b ) ) {
+        if ( comp( *b, *c ) ) {
+            std::iter_swap( result, b );
+        } else if ( comp( *a, *c ) ) {
+            std::iter_swap( result, c );
+        } else {
+            std::iter_swap( result, a );
+        }
+    } else if ( comp( *a, *c ) ) {
+        std::iter_swap( result, a );
+    } else if ( comp( *b, *c ) ) {
+        std::iter_swap( result, c );
+    } else {
+        std::iter_swap( result, b );
+    }
+}
+
+// Introselect: quickselect on a median-of-three pivot, falling back to a heap select once the
+// recursion depth passes 2 log n, which bounds the worst case at O(n log n).
+template< std::random_access_iterator It, class Comp >
+constexpr void __introselect( It first, It nth, It last, Comp& comp ) {
+    if ( nth == last ) {
+        return;
+    }
+    int depth = 2 * int( std::bit_width( static_cast<std::size_t>( last - first ) ) );
+    while ( last - first > 16 ) {
+        if ( depth-- == 0 ) {
+            mystd::__heap_select( first, nth + 1, last, comp );
+            std::iter_swap( first, nth );
+            return;
+        }
+        mystd::__move_median_to_first( first, first + 1, first + ( last - first ) / 2, last - 1, comp );
+        It lo = first + 1;
+        It hi = last;
+        while ( true ) {
+            while ( comp( *lo, *first ) ) {
+                ++lo;
+            }
+            --hi;
+            while ( comp( *first, *hi ) ) {
+                --hi;
+            }
+            if ( !( lo < hi ) ) {
+                break;
+            }
+            std::iter_swap( lo, hi );
+            ++lo;
+        }
+        if ( lo <= nth ) {
+            first = lo;
+        } else {
+            last = lo;
+        }
+    }
+    mystd::__insertion_sort( first, last, comp );
+}
+
+template< std::random_access_iterator It, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::sortable<It, Comp, Proj>
+constexpr void partial_sort( It first, It middle, It last, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    mystd::__partial_sort( first, middle, last, pcomp );
+}
+
+template< std::input_iterator InIt, std::random_access_iterator RIt, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::indirectly_copyable<InIt, RIt> && std::sortable<RIt, Comp, Proj> && std::indirect_strict_weak_order<Comp, std::projected<InIt, Proj>, std::projected<RIt, Proj>>
+constexpr RIt partial_sort_copy( InIt first, InIt last, RIt result_first, RIt result_last, Comp comp = {}, Proj proj = {} ) {
+    using diff_t = typename std::iterator_traits<RIt>::difference_type;
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    RIt result = result_first;
+    for ( ; first != last && result != result_last; ++first, ++result ) {
+        *result = *first;
+    }
+    const diff_t k = result - result_first;
+    if ( k == 0 ) {
+        return result;
+    }
+    mystd::__make_heap( result_first, result, pcomp );
+    for ( ; first != last; ++first ) {
+        if ( pcomp( *first, *result_first ) ) {
+            mystd::__adjust_heap( result_first, diff_t( 0 ), k, typename std::iterator_traits<RIt>::value_type( *first ), pcomp );
+        }
+    }
+    mystd::sort_heap( result_first, result, pcomp );
+    return result;
+}
+
+template< std::random_access_iterator It, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::sortable<It, Comp, Proj>
+constexpr void nth_element( It first, It nth, It last, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    mystd::__introselect( first, nth, last, pcomp );
+}
+
+// Writes the k greatest elements of [first, last) to out, greatest first: the same elements, in
+// the same order, that k pops of a priority_queue with the same comparator would produce.
+template< std::input_iterator It, std::weakly_incrementable Out, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::indirectly_copyable<It, Out> && std::indirect_strict_weak_order<Comp, std::projected<It, Proj>>
+constexpr Out top_k( It first, It last, std::size_t k, Out out, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    __inverted_compare<__projected_compare<Comp, Proj>> icomp{ pcomp };
+    std::vector<std::iter_value_t<It>> buf;
+    mystd::__heap_select_copy( first, last, k, buf, icomp );
+    mystd::sort_heap( buf.begin(), buf.end(), icomp );
+    return std::move( buf.begin(), buf.end(), std::move( out ) );
+}
+
+// Parallel selection of the k smallest: every chunk moves its own k smallest to its front in
+// parallel, those prefixes are gathered at the start of the range, and the serial algorithm then
+// runs on the k * workers candidates only. Every element left out is preceded by k candidates of
+// its chunk that are no greater, so it cannot be among the k smallest. Returns the end of the
+// candidates, or first when the range is too small or k too large for chunking to pay off.
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp >
+It __gather_smallest( ExecutionPolicy&&, It first, It last, typename std::iterator_traits<It>::difference_type k, Comp& comp ) {
+    using diff_t = typename std::iterator_traits<It>::difference_type;
+    const diff_t size = last - first;
+    const unsigned workers = mystd::__parallel_workers( size );
+    if ( !__is_parallel_policy_v<ExecutionPolicy> || workers <= 1 || k == 0 || 2 * k * diff_t( workers ) > size ) {
+        return first;
+    }
+    auto bound = [&]( std::ptrdiff_t chunk ) { return first + size * chunk / workers; };
+    mystd::__parallel_for( workers, workers, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+        for ( std::ptrdiff_t chunk = begin; chunk < end; ++chunk ) {
+            mystd::__heap_select( bound( chunk ), bound( chunk ) + k, bound( chunk + 1 ), comp );
+        }
+    } );
+    It dest = first + k;
+    for ( unsigned chunk = 1; chunk < workers; ++chunk, dest += k ) {
+        It src = bound( chunk );
+        if ( src - dest >= k ) {
+            std::swap_ranges( src, src + k, dest );
+        } else if ( src != dest ) {
+            std::rotate( dest, src, src + k );
+        }
+    }
+    return dest;
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::sortable<It, Comp, Proj>
+void partial_sort( ExecutionPolicy&& policy, It first, It middle, It last, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    It candidates = mystd::__gather_smallest( std::forward<ExecutionPolicy>( policy ), first, last, middle - first, pcomp );
+    mystd::__partial_sort( first, middle, candidates == first ? last : candidates, pcomp );
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::sortable<It, Comp, Proj>
+void nth_element( ExecutionPolicy&& policy, It first, It nth, It last, Comp comp = {}, Proj proj = {} ) {
+    if ( nth == last ) {
+        return;
+    }
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    It candidates = mystd::__gather_smallest( std::forward<ExecutionPolicy>( policy ), first, last, nth - first + 1, pcomp );
+    mystd::__introselect( first, nth, candidates == first ? last : candidates, pcomp );
+}
+
+// Each chunk copies out its own k best candidates in parallel; the serial algorithm then picks
+// the final k from those.
+template< class ExecutionPolicy, std::random_access_iterator It, class T, class Comp >
+bool __gather_copy( ExecutionPolicy&&, It first, It last, std::size_t k, std::vector<T>& candidates, Comp& comp ) {
+    const std::ptrdiff_t size = last - first;
+    const unsigned workers = mystd::__parallel_workers( size );
+    if ( !__is_parallel_policy_v<ExecutionPolicy> || workers <= 1 || k == 0 || 2 * k * workers > std::size_t( size ) ) {
+        return false;
+    }
+    std::vector<std::vector<T>> local( workers );
+    mystd::__parallel_for( workers, workers, [&]( std::ptrdiff_t begin, std::ptrdiff_t end ) {
+        for ( std::ptrdiff_t chunk = begin; chunk < end; ++chunk ) {
+            mystd::__heap_select_copy( first + size * chunk / workers, first + size * ( chunk + 1 ) / workers, k, local[ chunk ], comp );
+        }
+    } );
+    candidates.reserve( k * workers );
+    for ( std::vector<T>& part : local ) {
+        std::move( part.begin(), part.end(), std::back_inserter( candidates ) );
+    }
+    return true;
+}
+
+template< class ExecutionPolicy, std::random_access_iterator InIt, std::random_access_iterator RIt, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::indirectly_copyable<InIt, RIt> && std::sortable<RIt, Comp, Proj>
+      && std::indirect_strict_weak_order<Comp, std::projected<InIt, Proj>, std::projected<RIt, Proj>>
+RIt partial_sort_copy( ExecutionPolicy&& policy, InIt first, InIt last, RIt result_first, RIt result_last, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    std::vector<std::iter_value_t<InIt>> candidates;
+    if ( !mystd::__gather_copy( std::forward<ExecutionPolicy>( policy ), first, last, std::size_t( result_last - result_first ), candidates, pcomp ) ) {
+        return mystd::partial_sort_copy( first, last, result_first, result_last, comp, proj );
+    }
+    return mystd::partial_sort_copy( candidates.begin(), candidates.end(), result_first, result_last, comp, proj );
+}
+
+template< class ExecutionPolicy, std::random_access_iterator It, std::weakly_incrementable Out, class Comp = std::ranges::less, class Proj = std::identity >
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::indirectly_copyable<It, Out> && std::indirect_strict_weak_order<Comp, std::projected<It, Proj>>
+Out top_k( ExecutionPolicy&& policy, It first, It last, std::size_t k, Out out, Comp comp = {}, Proj proj = {} ) {
+    __projected_compare<Comp, Proj> pcomp{ comp, proj };
+    __inverted_compare<__projected_compare<Comp, Proj>> icomp{ pcomp };
+    std::vector<std::iter_value_t<It>> candidates;
+    if ( !mystd::__gather_copy( std::forward<ExecutionPolicy>( policy ), first, last, k, candidates, icomp ) ) {
+        return mystd::top_k( first, last, k, std::move( out ), comp, proj );
+    }
+    return mystd::top_k( std::make_move_iterator( candidates.begin() ), std::make_move_iterator( candidates.end() ), k, std::move( out ), comp, proj );
+}
+
+} // namespace mystd
@@ -1,14 +1,66 @@
 #pragma once // allocator.hpp
 
+#ifndef _MYSTD_MMAP_THRESHOLD
+#define _MYSTD_MMAP_THRESHOLD 4194304
+#endif
+
+#include <algorithm>
+#include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <new>
 #include <type_traits>
 #include <memory>
 #include <utility>
+#include "is_trivially_relocatable.hpp"
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace mystd {
 
+#if defined(__linux__)
+// On Linux, allocator<T> maps blocks of at least _MYSTD_MMAP_THRESHOLD bytes straight from the
+// kernel, so that growing them is an mremap of their pages rather than a copy. Only trivially
+// relocatable T qualify, since mremap may move the bytes. Whether a block is mapped follows from T and
+// its size alone, which deallocate is always given.
+inline bool __is_mapped_block( std::size_t bytes ) noexcept {
+    return bytes >= _MYSTD_MMAP_THRESHOLD;
+}
+
+inline std::size_t __page_round( std::size_t bytes ) noexcept {
+    static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+inline void* __map_block( std::size_t bytes ) {
+    void* p = ::mmap(nullptr, mystd::__page_round(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc{};
+    return p;
+}
+
+inline void __unmap_block( void* p, std::size_t bytes ) noexcept {
+    ::munmap(p, mystd::__page_round(bytes));
+}
+
+// Returns the new address of the block, or nullptr if it could not be resized (in place, unless may_move).
+inline void* __remap_block( void* p, std::size_t bytes, std::size_t new_bytes, bool may_move ) noexcept {
+    std::size_t old_size = mystd::__page_round(bytes);
+    std::size_t new_size = mystd::__page_round(new_bytes);
+    if (old_size == new_size) return p;
+    void* q = ::mremap(p, old_size, new_size, may_move ? MREMAP_MAYMOVE : 0);
+    return q == MAP_FAILED ? nullptr : q;
+}
+#endif
+
+template< class Pointer, class SizeType = std::size_t >
+struct allocation_result {
+    Pointer ptr;
+    SizeType count;
+};
+
 template< class T >
 struct allocator {
     using value_type = T;
@@ -23,16 +75,72 @@ struct allocator {
     constexpr allocator(const allocator<U>& other) noexcept {};
     constexpr ~allocator() = default;
 
+private:
+#if defined(__linux__)
+    static bool __mapped( std::size_t n ) noexcept {
+        if constexpr (mystd::is_trivially_relocatable_v<T>) return mystd::__is_mapped_block(n * sizeof(T));
+        else return false;
+    }
+#endif
+
+public:
     [[nodiscard]] constexpr T* allocate(std::size_t n) {
         if (std::numeric_limits<std::size_t>::max() / sizeof(T) < n) {
             throw std::bad_array_new_length{};
         }
+#if defined(__linux__)
+        if (__mapped(n)) return static_cast<T*>(mystd::__map_block(n * sizeof(T)));
+#endif
         return static_cast<T*>(::operator new(n * sizeof(T)));
     }
 
-    constexpr void deallocate(T* p, std::size_t) noexcept {
+    // As allocate, but reports how many elements fit in the block: mapped blocks are whole pages.
+    [[nodiscard]] constexpr allocation_result<T*> allocate_at_least(std::size_t n) {
+        T* p = allocate(n);
+#if defined(__linux__)
+        if (__mapped(n)) return { p, mystd::__page_round(n * sizeof(T)) / sizeof(T) };
+#endif
+        return { p, n };
+    }
+
+    constexpr void deallocate(T* p, std::size_t n) noexcept {
+#if defined(__linux__)
+        if (__mapped(n)) return mystd::__unmap_block(p, n * sizeof(T));
+#endif
         ::operator delete(p);
     }
+
+    // Grows the n-element block at p to at least new_n elements without moving it and returns how many
+    // elements it now holds, or 0 if it cannot grow. Only mapped blocks can grow, to whole pages.
+    std::size_t expand(T* p, std::size_t n, std::size_t new_n) noexcept {
+#if defined(__linux__)
+        if (new_n >= n && __mapped(n) && new_n <= std::numeric_limits<std::size_t>::max() / sizeof(T)
+            && mystd::__remap_block(p, n * sizeof(T), new_n * sizeof(T), false))
+            return mystd::__page_round(new_n * sizeof(T)) / sizeof(T);
+#endif
+        (void)p, (void)n, (void)new_n;
+        return 0;
+    }
+
+    // Moves the first used elements of the n-element block at p into a block of new_n elements by
+    // copying their bytes, so T must be trivially relocatable. Mapped blocks are remapped; on failure
+    // the old block is left untouched.
+    [[nodiscard]] allocation_result<T*> reallocate(T* p, std::size_t n, std::size_t new_n, std::size_t used) {
+        if (std::numeric_limits<std::size_t>::max() / sizeof(T) < new_n) {
+            throw std::bad_array_new_length{};
+        }
+#if defined(__linux__)
+        if (__mapped(n) && __mapped(new_n)) {
+            void* q = mystd::__remap_block(p, n * sizeof(T), new_n * sizeof(T), true);
+            if (!q) throw std::bad_alloc{};
+            return { static_cast<T*>(q), mystd::__page_round(new_n * sizeof(T)) / sizeof(T) };
+        }
+#endif
+        allocation_result<T*> block = allocate_at_least(new_n);
+        std::memcpy(static_cast<void*>(block.ptr), static_cast<const void*>(p), std::min(used, new_n) * sizeof(T));
+        deallocate(p, n);
+        return block;
+    }
 };
 
 template< class T1, class T2 >
@@ -158,10 +266,58 @@ public:
         }
     }
 
+    // Allocates at least n elements and returns how many the block holds; deallocate may then be given
+    // any size from n up to that count. Allocators without allocate_at_least get exactly n.
+    static constexpr allocation_result<pointer, size_type> allocate_at_least(Alloc& a, size_type n) {
+        if constexpr (requires { a.allocate_at_least(n); }) {
+            auto [p, count] = a.allocate_at_least(n);
+            return { p, static_cast<size_type>(count) };
+        } else {
+            return { a.allocate(n), n };
+        }
+    }
+
     static constexpr void deallocate(Alloc& a, pointer p, size_type n) {
         a.deallocate(p, n);
     }
 
+    // Grows the n-element block at p to at least new_n elements in place if Alloc has expand(p, n, new_n)
+    // and returns how many elements the block now holds, or 0 if it did not grow. Alloc::expand may
+    // return either that count or a bool, which stands for exactly new_n.
+    static constexpr size_type expand(Alloc& a, pointer p, size_type n, size_type new_n) noexcept {
+        if constexpr (requires { { a.expand(p, n, new_n) } -> std::same_as<bool>; }) {
+            return a.expand(p, n, new_n) ? new_n : 0;
+        } else if constexpr (requires { { a.expand(p, n, new_n) } -> std::convertible_to<size_type>; }) {
+            return static_cast<size_type>(a.expand(p, n, new_n));
+        } else {
+            (void)a, (void)p, (void)n, (void)new_n;
+            return 0;
+        }
+    }
+
+    // Moves the bytes of the first used elements of the n-element block at p into a block of at least
+    // new_n elements and frees the old one, through Alloc::reallocate(p, n, new_n, used) if there is
+    // one, else Alloc::reallocate(p, n, new_n); either may return the new pointer or an
+    // allocation_result. Only for trivially relocatable value types.
+    static constexpr allocation_result<pointer, size_type> reallocate(Alloc& a, pointer p, size_type n, size_type new_n, size_type used) {
+        if constexpr (requires { { a.reallocate(p, n, new_n, used) } -> std::convertible_to<pointer>; }) {
+            return { a.reallocate(p, n, new_n, used), new_n };
+        } else if constexpr (requires { a.reallocate(p, n, new_n, used).count; }) {
+            auto [q, count] = a.reallocate(p, n, new_n, used);
+            return { q, static_cast<size_type>(count) };
+        } else if constexpr (requires { { a.reallocate(p, n, new_n) } -> std::convertible_to<pointer>; }) {
+            return { a.reallocate(p, n, new_n), new_n };
+        } else if constexpr (requires { a.reallocate(p, n, new_n).count; }) {
+            auto [q, count] = a.reallocate(p, n, new_n);
+            return { q, static_cast<size_type>(count) };
+        } else {
+            auto [q, count] = allocate_at_least(a, new_n);
+            std::memcpy(static_cast<void*>(std::to_address(q)), static_cast<const void*>(std::to_address(p)), std::min(used, new_n) * sizeof(value_type));
+            a.deallocate(p, n);
+            return { q, count };
+        }
+    }
+
     static constexpr size_type max_size(const Alloc& a) noexcept {
         if constexpr (requires { a.max_size(); }) {
             return a.max_size();
@@ -10,6 +10,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include "is_trivially_relocatable.hpp"
 #include "range-access.hpp"
 #include "tuple_size.hpp"
 
@@ -80,6 +81,9 @@ struct array {
 template<class T, class... U>
 array(T, U...) -> array<T, 1 + sizeof...(U)>;
 
+template<class T, std::size_t N>
+struct is_trivially_relocatable<array<T, N>> : is_trivially_relocatable<T> {};
+
 } // namespace mystd
 
 template<class T, std::size_t N>
@@ -0,0 +1,178 @@
+#pragma once // bucket_queue.hpp
+
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "allocator.hpp"
+#include "array.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Priority queue over the integer levels [0, Levels), serving the highest non-empty level first
+// and elements within a level in FIFO order. Each level is a mystd::vector of optional slots consumed
+// from a head index, and pop resets the slot so the element's lifetime ends there; a bitmap with one
+// bit per level, packed in unsigned long long words like vector<bool>, finds the highest non-empty
+// level with countl_zero. push and pop are O(1).
+template<class T, std::size_t Levels = 256, class Allocator = mystd::allocator<T>>
+requires (Levels > 0)
+class bucket_queue {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using priority_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    static constexpr std::size_t levels = Levels;
+
+protected:
+    static constexpr std::size_t word_bit = sizeof(unsigned long long) * CHAR_BIT;
+    static constexpr std::size_t word_count = (Levels + word_bit - 1) / word_bit;
+
+    using slot_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<std::optional<T>>;
+
+    struct fifo {
+        mystd::vector<std::optional<T>, slot_allocator> elems;
+        std::size_t head = 0;
+    };
+
+    mystd::array<fifo, Levels> buckets;
+    mystd::array<unsigned long long, word_count> occupied{};
+    size_type sz = 0;
+
+    static constexpr std::size_t word_index( std::size_t pos ) noexcept { return pos / word_bit; }
+    static constexpr unsigned long long bit_mask( std::size_t pos ) noexcept { return 1ULL << (pos % word_bit); }
+
+    static void check( priority_type priority ) {
+        if (priority >= Levels) throw std::out_of_range("bucket_queue");
+    }
+
+public:
+    bucket_queue() = default;
+
+    explicit bucket_queue( const Allocator& alloc ) {
+        for (fifo& bucket : buckets) bucket.elems = mystd::vector<std::optional<T>, slot_allocator>(slot_allocator(alloc));
+    }
+
+    bucket_queue( const bucket_queue& other ) = default;
+
+    bucket_queue( bucket_queue&& other ) noexcept = default;
+
+    ~bucket_queue() = default;
+
+    bucket_queue& operator=( const bucket_queue& other ) = default;
+
+    bucket_queue& operator=( bucket_queue&& other ) noexcept = default;
+
+    priority_type top_priority() const {
+        for (std::size_t w = word_count; w-- > 0; ) {
+            if (occupied[w]) return w * word_bit + (word_bit - 1 - static_cast<std::size_t>(std::countl_zero(occupied[w])));
+        }
+        return 0;
+    }
+
+    const_reference top() const {
+        const fifo& bucket = buckets[top_priority()];
+        return *bucket.elems[bucket.head];
+    }
+
+    bool empty() const {
+        return sz == 0;
+    }
+
+    size_type size() const {
+        return sz;
+    }
+
+    size_type count( priority_type priority ) const {
+        check(priority);
+        return buckets[priority].elems.size() - buckets[priority].head;
+    }
+
+    void push( priority_type priority, const value_type& value ) {
+        check(priority);
+        buckets[priority].elems.push_back(value);
+        occupied[word_index(priority)] |= bit_mask(priority);
+        ++sz;
+    }
+
+    void push( priority_type priority, value_type&& value ) {
+        check(priority);
+        buckets[priority].elems.push_back(std::move(value));
+        occupied[word_index(priority)] |= bit_mask(priority);
+        ++sz;
+    }
+
+    template< class Arg >
+    reference emplace( priority_type priority, Arg&& arg ) {
+        check(priority);
+        reference result = *buckets[priority].elems.emplace_back(std::forward<Arg>(arg));
+        occupied[word_index(priority)] |= bit_mask(priority);
+        ++sz;
+        return result;
+    }
+
+    // A drained level is cleared in place so its storage is reused; a level whose consumed prefix
+    // outgrows the live elements is compacted, keeping pop amortized O(1).
+    void pop() {
+        priority_type priority = top_priority();
+        fifo& bucket = buckets[priority];
+        bucket.elems[bucket.head].reset();
+        ++bucket.head;
+        --sz;
+        if (bucket.head == bucket.elems.size()) {
+            bucket.elems.clear();
+            bucket.head = 0;
+            occupied[word_index(priority)] &= ~bit_mask(priority);
+        } else if (bucket.head >= 32 && bucket.head * 2 >= bucket.elems.size()) {
+            bucket.elems.erase(bucket.elems.begin(), bucket.elems.begin() + bucket.head);
+            bucket.head = 0;
+        }
+    }
+
+    value_type pop_value() {
+        fifo& bucket = buckets[top_priority()];
+        value_type value = std::move(*bucket.elems[bucket.head]);
+        pop();
+        return value;
+    }
+
+    void clear() noexcept {
+        for (fifo& bucket : buckets) {
+            bucket.elems.clear();
+            bucket.head = 0;
+        }
+        for (unsigned long long& word : occupied) word = 0;
+        sz = 0;
+    }
+
+    void swap( bucket_queue& other ) noexcept {
+        for (std::size_t i = 0; i < Levels; ++i) {
+            buckets[i].elems.swap(other.buckets[i].elems);
+            std::swap(buckets[i].head, other.buckets[i].head);
+        }
+        std::swap(occupied, other.occupied);
+        std::swap(sz, other.sz);
+    }
+};
+
+template< class T, std::size_t Levels, class Allocator >
+requires (Levels > 0)
+struct is_trivially_relocatable<mystd::bucket_queue<T, Levels, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, std::size_t Levels, class Allocator >
+void swap( mystd::bucket_queue<T, Levels, Allocator>& lhs, mystd::bucket_queue<T, Levels, Allocator>& rhs ) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,272 @@
+#pragma once // external_priority_queue.hpp
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include "algorithm-heap.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Priority queue that outgrows memory by spilling to local temporary files (std::tmpfile, removed on
+// close). New elements go into an in-memory insertion heap; once it reaches the memory budget it is
+// sorted and written out as a run. top() and pop() merge the insertion heap with the runs through a
+// small heap of run heads, each run being read sequentially one block at a time. Runs are kept in
+// levels: a spilled run is level 0, and once a level holds fan_in() runs (enough read buffers to fill
+// a quarter of the budget) they are merged into one run of the next level. Each element is thus
+// rewritten once per level, O(log(N / M) / log(M / B)) times for N elements, budget M and block B.
+// Elements are written as raw bytes, so T must be trivially copyable.
+template<class T, class Compare = std::less<T>>
+requires std::is_trivially_copyable_v<T> && std::predicate<Compare, const T&, const T&>
+class external_priority_queue {
+public:
+    using value_type = T;
+    using value_compare = Compare;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+    static constexpr std::size_t default_memory_limit = std::size_t(64) << 20;
+    static constexpr std::size_t default_block_size = std::size_t(1) << 20;
+
+protected:
+    struct file_closer {
+        void operator()( std::FILE* file ) const { std::fclose(file); }
+    };
+
+    struct run {
+        std::unique_ptr<std::FILE, file_closer> file;
+        mystd::vector<T> buffer;
+        std::size_t pos = 0;
+        std::size_t on_disk = 0;
+        std::size_t level = 0;
+
+        const T& head() const { return buffer[pos]; }
+    };
+
+    mystd::vector<T> heap;
+    mystd::vector<run> runs;
+    mystd::vector<std::size_t> heads;
+    Compare comp = Compare();
+    std::size_t mem_limit;
+    std::size_t block_elems;
+    size_type spilled = 0;
+
+    static std::FILE* open_file() {
+        std::FILE* file = std::tmpfile();
+        if (!file) throw std::runtime_error("external_priority_queue");
+        return file;
+    }
+
+    static void write( std::FILE* file, const T* data, std::size_t count ) {
+        if (count && std::fwrite(data, sizeof(T), count, file) != count) throw std::runtime_error("external_priority_queue");
+    }
+
+    void refill( run& r ) {
+        std::size_t count = std::min(block_elems, r.on_disk);
+        r.buffer.resize(count);
+        if (count && std::fread(r.buffer.data(), sizeof(T), count, r.file.get()) != count) throw std::runtime_error("external_priority_queue");
+        r.on_disk -= count;
+        r.pos = 0;
+    }
+
+    auto head_compare() const {
+        return [this]( std::size_t lhs, std::size_t rhs ) { return comp(runs[lhs].head(), runs[rhs].head()); };
+    }
+
+    // Starts reading back count elements from file as a run of the given level, reusing the slot of an
+    // exhausted run if any.
+    void open_run( std::FILE* file, std::size_t count, std::size_t level ) {
+        std::unique_ptr<std::FILE, file_closer> owner(file);
+        if (std::fflush(file) != 0 || std::fseek(file, 0, SEEK_SET) != 0) throw std::runtime_error("external_priority_queue");
+        std::size_t index = 0;
+        while (index < runs.size() && runs[index].file) ++index;
+        if (index == runs.size()) runs.push_back(run());
+        run& r = runs[index];
+        r.file = std::move(owner);
+        r.on_disk = count;
+        r.level = level;
+        refill(r);
+        heads.push_back(index);
+        mystd::push_heap(heads.begin(), heads.end(), head_compare());
+    }
+
+    // Removes the greatest head in the heap of run heads from, advancing its run and dropping the run
+    // once it is drained.
+    T take_head( mystd::vector<std::size_t>& from ) {
+        mystd::pop_heap(from.begin(), from.end(), head_compare());
+        run& r = runs[from.back()];
+        T value = r.head();
+        if (++r.pos == r.buffer.size()) refill(r);
+        if (r.buffer.empty()) {
+            r.file.reset();
+            r.buffer = mystd::vector<T>();
+            from.pop_back();
+        } else {
+            mystd::push_heap(from.begin(), from.end(), head_compare());
+        }
+        return value;
+    }
+
+    std::size_t runs_at( std::size_t level ) const {
+        return static_cast<std::size_t>(std::count_if(heads.begin(), heads.end(), [&]( std::size_t i ) { return runs[i].level == level; }));
+    }
+
+    // Runs of one level merged at once: as many as there are read buffers in a quarter of the budget.
+    std::size_t fan_in() const {
+        return std::max<std::size_t>(mem_limit / block_bytes() / 4, 2);
+    }
+
+    // Merges the runs of level into one run of the next level, cascading while levels are full.
+    void merge_level( std::size_t level ) {
+        auto split = std::partition(heads.begin(), heads.end(), [&]( std::size_t i ) { return runs[i].level != level; });
+        mystd::vector<std::size_t> group(split, heads.end());
+        heads.resize(static_cast<std::size_t>(split - heads.begin()));
+        mystd::make_heap(heads.begin(), heads.end(), head_compare());
+        mystd::make_heap(group.begin(), group.end(), head_compare());
+        std::FILE* file = open_file();
+        std::unique_ptr<std::FILE, file_closer> owner(file);
+        mystd::vector<T> out;
+        out.reserve(block_elems);
+        std::size_t count = 0;
+        while (!group.empty()) {
+            out.push_back(take_head(group));
+            if (out.size() == block_elems) {
+                write(file, out.data(), out.size());
+                count += out.size();
+                out.clear();
+            }
+        }
+        write(file, out.data(), out.size());
+        count += out.size();
+        open_run(owner.release(), count, level + 1);
+        if (runs_at(level + 1) >= fan_in()) merge_level(level + 1);
+    }
+
+    std::size_t block_bytes() const {
+        return block_elems * sizeof(T);
+    }
+
+    // Insertion heap capacity left over once every run, plus the next one, has its read buffer.
+    std::size_t heap_limit() const {
+        std::size_t buffers = (heads.size() + 1) * block_bytes();
+        return mem_limit > buffers ? std::max(block_elems, (mem_limit - buffers) / sizeof(T)) : block_elems;
+    }
+
+    void spill() {
+        mystd::sort_heap(heap.begin(), heap.end(), comp);
+        std::reverse(heap.begin(), heap.end());
+        std::FILE* file = open_file();
+        std::unique_ptr<std::FILE, file_closer> owner(file);
+        write(file, heap.data(), heap.size());
+        open_run(owner.release(), heap.size(), 0);
+        spilled += heap.size();
+        heap.clear();
+        if (runs_at(0) >= fan_in()) merge_level(0);
+    }
+
+    bool top_in_runs() const {
+        return !heads.empty() && (heap.empty() || comp(heap.front(), runs[heads.front()].head()));
+    }
+
+public:
+    explicit external_priority_queue( std::size_t memory_limit = default_memory_limit, std::size_t block_size = default_block_size, const Compare& compare = Compare() ) : comp(compare), mem_limit(memory_limit), block_elems(std::max<std::size_t>(block_size / sizeof(T), 1)) {}
+
+    external_priority_queue( const external_priority_queue& ) = delete;
+
+    external_priority_queue( external_priority_queue&& other ) noexcept = default;
+
+    ~external_priority_queue() = default;
+
+    external_priority_queue& operator=( const external_priority_queue& ) = delete;
+
+    external_priority_queue& operator=( external_priority_queue&& other ) noexcept = default;
+
+    const_reference top() const {
+        return top_in_runs() ? runs[heads.front()].head() : heap.front();
+    }
+
+    bool empty() const {
+        return heap.empty() && heads.empty();
+    }
+
+    size_type size() const {
+        return heap.size() + spilled;
+    }
+
+    std::size_t memory_limit() const {
+        return mem_limit;
+    }
+
+    std::size_t block_size() const {
+        return block_bytes();
+    }
+
+    size_type run_count() const {
+        return heads.size();
+    }
+
+    void push( const value_type& value ) {
+        heap.push_back(value);
+        mystd::push_heap(heap.begin(), heap.end(), comp);
+        if (heap.size() >= heap_limit()) spill();
+    }
+
+    template< class... Args >
+    void emplace( Args&&... args ) {
+        push(value_type(std::forward<Args>(args)...));
+    }
+
+    void pop() {
+        pop_value();
+    }
+
+    value_type pop_value() {
+        if (top_in_runs()) {
+            --spilled;
+            return take_head(heads);
+        }
+        mystd::pop_heap(heap.begin(), heap.end(), comp);
+        value_type value = heap.back();
+        heap.pop_back();
+        return value;
+    }
+
+    void clear() {
+        heap.clear();
+        runs.clear();
+        heads.clear();
+        spilled = 0;
+    }
+
+    void swap( external_priority_queue& other ) noexcept {
+        heap.swap(other.heap);
+        runs.swap(other.runs);
+        heads.swap(other.heads);
+        std::swap(comp, other.comp);
+        std::swap(mem_limit, other.mem_limit);
+        std::swap(block_elems, other.block_elems);
+        std::swap(spilled, other.spilled);
+    }
+};
+
+template< class T, class Compare >
+requires std::is_trivially_copyable_v<T> && std::predicate<Compare, const T&, const T&>
+struct is_trivially_relocatable<mystd::external_priority_queue<T, Compare>> : is_trivially_relocatable<Compare> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, class Compare >
+requires std::is_trivially_copyable_v<T> && std::predicate<Compare, const T&, const T&>
+void swap( mystd::external_priority_queue<T, Compare>& lhs, mystd::external_priority_queue<T, Compare>& rhs ) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,214 @@
+#pragma once // heap-simd.hpp
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace mystd {
+
+// Vector operations used to pick the best of a run of children in a wide heap of arithmetic keys.
+// all_max/all_min leave the extreme value in every lane, so it can be compared against the
+// children directly; eq_mask returns one bit per lane.
+template< class T >
+struct __simd_heap_ops {
+    static constexpr bool available = false;
+};
+
+#if defined(__AVX2__)
+
+template<>
+struct __simd_heap_ops<std::int32_t> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 8;
+    using reg = __m256i;
+    static reg load( const std::int32_t* p ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ); }
+    static reg max( reg a, reg b ) { return _mm256_max_epi32( a, b ); }
+    static reg min( reg a, reg b ) { return _mm256_min_epi32( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? _mm256_max_epi32( a, b ) : _mm256_min_epi32( a, b ); };
+        x = op( x, _mm256_permute2x128_si256( x, x, 1 ) );
+        x = op( x, _mm256_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        return op( x, _mm256_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( a, b ) ) ) ); }
+};
+
+template<>
+struct __simd_heap_ops<std::uint64_t> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 4;
+    using reg = __m256i;
+    static reg load( const std::uint64_t* p ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ); }
+    static reg greater( reg a, reg b ) {
+        const reg sign = _mm256_set1_epi64x( std::int64_t( 1ULL << 63 ) );
+        return _mm256_cmpgt_epi64( _mm256_xor_si256( a, sign ), _mm256_xor_si256( b, sign ) );
+    }
+    static reg max( reg a, reg b ) { return _mm256_blendv_epi8( b, a, greater( a, b ) ); }
+    static reg min( reg a, reg b ) { return _mm256_blendv_epi8( a, b, greater( a, b ) ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? max( a, b ) : min( a, b ); };
+        x = op( x, _mm256_permute2x128_si256( x, x, 1 ) );
+        return op( x, _mm256_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpeq_epi64( a, b ) ) ) ); }
+};
+
+template<>
+struct __simd_heap_ops<float> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 8;
+    using reg = __m256;
+    static reg load( const float* p ) { return _mm256_loadu_ps( p ); }
+    static reg max( reg a, reg b ) { return _mm256_max_ps( a, b ); }
+    static reg min( reg a, reg b ) { return _mm256_min_ps( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? _mm256_max_ps( a, b ) : _mm256_min_ps( a, b ); };
+        x = op( x, _mm256_permute2f128_ps( x, x, 1 ) );
+        x = op( x, _mm256_permute_ps( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        return op( x, _mm256_permute_ps( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm256_movemask_ps( _mm256_cmp_ps( a, b, _CMP_EQ_OQ ) ) ); }
+};
+
+template<>
+struct __simd_heap_ops<double> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 4;
+    using reg = __m256d;
+    static reg load( const double* p ) { return _mm256_loadu_pd( p ); }
+    static reg max( reg a, reg b ) { return _mm256_max_pd( a, b ); }
+    static reg min( reg a, reg b ) { return _mm256_min_pd( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? _mm256_max_pd( a, b ) : _mm256_min_pd( a, b ); };
+        x = op( x, _mm256_permute2f128_pd( x, x, 1 ) );
+        return op( x, _mm256_permute_pd( x, 0x5 ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm256_movemask_pd( _mm256_cmp_pd( a, b, _CMP_EQ_OQ ) ) ); }
+};
+
+#elif defined(__SSE4_1__)
+
+template<>
+struct __simd_heap_ops<std::int32_t> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 4;
+    using reg = __m128i;
+    static reg load( const std::int32_t* p ) { return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ); }
+    static reg max( reg a, reg b ) { return _mm_max_epi32( a, b ); }
+    static reg min( reg a, reg b ) { return _mm_min_epi32( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? _mm_max_epi32( a, b ) : _mm_min_epi32( a, b ); };
+        x = op( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        return op( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( a, b ) ) ) ); }
+};
+
+#if defined(__SSE4_2__)
+template<>
+struct __simd_heap_ops<std::uint64_t> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 2;
+    using reg = __m128i;
+    static reg load( const std::uint64_t* p ) { return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ); }
+    static reg greater( reg a, reg b ) {
+        const reg sign = _mm_set1_epi64x( std::int64_t( 1ULL << 63 ) );
+        return _mm_cmpgt_epi64( _mm_xor_si128( a, sign ), _mm_xor_si128( b, sign ) );
+    }
+    static reg max( reg a, reg b ) { return _mm_blendv_epi8( b, a, greater( a, b ) ); }
+    static reg min( reg a, reg b ) { return _mm_blendv_epi8( a, b, greater( a, b ) ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        reg y = _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+        return Max ? max( x, y ) : min( x, y );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpeq_epi64( a, b ) ) ) ); }
+};
+#endif
+
+template<>
+struct __simd_heap_ops<float> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 4;
+    using reg = __m128;
+    static reg load( const float* p ) { return _mm_loadu_ps( p ); }
+    static reg max( reg a, reg b ) { return _mm_max_ps( a, b ); }
+    static reg min( reg a, reg b ) { return _mm_min_ps( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        auto op = []( reg a, reg b ) { return Max ? _mm_max_ps( a, b ) : _mm_min_ps( a, b ); };
+        x = op( x, _mm_shuffle_ps( x, x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        return op( x, _mm_shuffle_ps( x, x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm_movemask_ps( _mm_cmpeq_ps( a, b ) ) ); }
+};
+
+template<>
+struct __simd_heap_ops<double> {
+    static constexpr bool available = true;
+    static constexpr std::size_t lanes = 2;
+    using reg = __m128d;
+    static reg load( const double* p ) { return _mm_loadu_pd( p ); }
+    static reg max( reg a, reg b ) { return _mm_max_pd( a, b ); }
+    static reg min( reg a, reg b ) { return _mm_min_pd( a, b ); }
+    template< bool Max >
+    static reg all( reg x ) {
+        reg y = _mm_shuffle_pd( x, x, 1 );
+        return Max ? _mm_max_pd( x, y ) : _mm_min_pd( x, y );
+    }
+    static unsigned eq_mask( reg a, reg b ) { return unsigned( _mm_movemask_pd( _mm_cmpeq_pd( a, b ) ) ); }
+};
+
+#endif
+
+template< class Comp, class T >
+inline constexpr bool __is_less_compare_v = std::is_same_v<Comp, std::less<T>> || std::is_same_v<Comp, std::less<>>;
+
+template< class Comp, class T >
+inline constexpr bool __is_greater_compare_v = std::is_same_v<Comp, std::greater<T>> || std::is_same_v<Comp, std::greater<>>;
+
+template< std::size_t Arity, class It, class Comp >
+constexpr bool __simd_heap_eligible() {
+    if constexpr ( std::contiguous_iterator<It> ) {
+        using T = std::remove_cv_t<typename std::iterator_traits<It>::value_type>;
+        if constexpr ( __simd_heap_ops<T>::available ) {
+            return ( Arity == 8 || Arity == 16 ) && Arity % __simd_heap_ops<T>::lanes == 0 && ( __is_less_compare_v<Comp, T> || __is_greater_compare_v<Comp, T> );
+        }
+    }
+    return false;
+}
+
+// Index of the first largest (Max) or smallest child among the Arity keys at p.
+template< std::size_t Arity, bool Max, class T >
+inline std::size_t __simd_best_child( const T* p ) {
+    using ops = __simd_heap_ops<T>;
+    constexpr std::size_t regs = Arity / ops::lanes;
+    typename ops::reg v[regs];
+    for ( std::size_t r = 0; r < regs; ++r ) {
+        v[r] = ops::load( p + r * ops::lanes );
+    }
+    typename ops::reg best = v[0];
+    for ( std::size_t r = 1; r < regs; ++r ) {
+        best = Max ? ops::max( best, v[r] ) : ops::min( best, v[r] );
+    }
+    best = ops::template all<Max>( best );
+    for ( std::size_t r = 0; r < regs; ++r ) {
+        if ( unsigned mask = ops::eq_mask( v[r], best ) ) {
+            return r * ops::lanes + std::size_t( std::countr_zero( mask ) );
+        }
+    }
+    return 0;
+}
+
+} // namespace mystd
@@ -0,0 +1,138 @@
+#pragma once // heap-stats.hpp
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "array.hpp"
+
+namespace mystd {
+
+// Operation-counting instrumentation for the heap algorithms and priority_queue. The algorithms
+// count through a wrapped comparator: __counting_compare bumps the comparison counter and makes
+// the __heap_note_* hooks in the sift helpers report moves and sift depth. With no_heap_stats
+// (the default) the comparator is passed through untouched and the hooks are empty, so nothing
+// is compiled in.
+
+enum class heap_op : unsigned char { push, pop, make, sort };
+
+struct heap_stats_snapshot {
+    static constexpr std::size_t op_count = 4;
+    static constexpr std::size_t latency_buckets = 32;
+
+    // latency_ns[i] counts calls that took [2^i, 2^(i+1)) nanoseconds; the last bucket is open-ended.
+    struct op_stats {
+        std::uint64_t calls = 0;
+        mystd::array<std::uint64_t, latency_buckets> latency_ns{};
+    };
+
+    std::uint64_t comparisons = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t swaps = 0;
+    std::uint64_t sifts = 0;
+    std::uint64_t sift_up_levels = 0;
+    std::uint64_t sift_down_levels = 0;
+    std::uint64_t max_sift_depth = 0;
+    mystd::array<op_stats, op_count> ops{};
+
+    const op_stats& operator[]( heap_op op ) const {
+        return ops[static_cast<std::size_t>(op)];
+    }
+};
+
+struct no_heap_stats {
+    static constexpr bool enabled = false;
+};
+
+class heap_stats {
+public:
+    static constexpr bool enabled = true;
+
+    void on_compare() noexcept {
+        ++counters.comparisons;
+    }
+
+    void on_moves( std::uint64_t count ) noexcept {
+        counters.moves += count;
+    }
+
+    void on_swaps( std::uint64_t count ) noexcept {
+        counters.swaps += count;
+    }
+
+    void on_sift( bool down, std::uint64_t levels ) noexcept {
+        ++counters.sifts;
+        (down ? counters.sift_down_levels : counters.sift_up_levels) += levels;
+        counters.max_sift_depth = std::max(counters.max_sift_depth, levels);
+    }
+
+    void on_operation( heap_op op, std::uint64_t nanoseconds ) noexcept {
+        heap_stats_snapshot::op_stats& stats = counters.ops[static_cast<std::size_t>(op)];
+        ++stats.calls;
+        std::size_t bucket = nanoseconds ? static_cast<std::size_t>(std::bit_width(nanoseconds)) - 1 : 0;
+        ++stats.latency_ns[std::min(bucket, heap_stats_snapshot::latency_buckets - 1)];
+    }
+
+    heap_stats_snapshot snapshot() const noexcept {
+        return counters;
+    }
+
+    void reset() noexcept {
+        counters = heap_stats_snapshot();
+    }
+
+private:
+    heap_stats_snapshot counters;
+};
+
+template< class Stats >
+concept __heap_stats_policy = requires { { Stats::enabled } -> std::convertible_to<bool>; };
+
+template< class Comp, class Stats >
+struct __counting_compare {
+    Comp* comp;
+    Stats* stats;
+
+    template< class L, class R >
+    bool operator()( L&& lhs, R&& rhs ) const {
+        stats->on_compare();
+        return (*comp)( std::forward<L>( lhs ), std::forward<R>( rhs ) );
+    }
+};
+
+template< class Comp >
+constexpr void __heap_note_moves( Comp&, std::ptrdiff_t ) {}
+
+template< class Comp, class Stats >
+void __heap_note_moves( __counting_compare<Comp, Stats>& comp, std::ptrdiff_t count ) {
+    comp.stats->on_moves( std::uint64_t( count ) );
+}
+
+template< class Comp >
+constexpr void __heap_note_sift( Comp&, bool, std::ptrdiff_t ) {}
+
+template< class Comp, class Stats >
+void __heap_note_sift( __counting_compare<Comp, Stats>& comp, bool down, std::ptrdiff_t levels ) {
+    comp.stats->on_sift( down, std::uint64_t( levels ) );
+}
+
+// Runs fn with comp, or with a counting wrapper around it and a latency measurement when Stats is enabled.
+template< class Stats, class Comp, class Fn >
+constexpr void __instrumented( Stats& stats, heap_op op, Comp& comp, Fn fn ) {
+    if constexpr ( Stats::enabled ) {
+        __counting_compare<Comp, Stats> counting{ &comp, &stats };
+        const auto start = std::chrono::steady_clock::now();
+        fn( counting );
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+        stats.on_operation( op, std::uint64_t( std::max<decltype( elapsed )>( elapsed, 0 ) ) );
+    } else {
+        (void)stats;
+        (void)op;
+        fn( comp );
+    }
+}
+
+} // namespace mystd
@@ -0,0 +1,266 @@
+#pragma once // indexed_priority_queue.hpp
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include "allocator.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Addressable priority queue: push returns a handle that stays valid until the element is popped
+// or erased, and through which the element can be read, re-prioritised or removed in O(log n).
+// The heap holds (value, handle) nodes; pos maps each live handle to its node's heap index and is
+// kept current by the sifts. Released handles are reused by later pushes.
+// update, increase_key and decrease_key compare the new value with the old one and sift whichever
+// way that requires, so decrease_key on a std::greater (min-)heap moves the element towards top().
+template<class T, class Compare = std::less<T>, class Allocator = mystd::allocator<T>>
+requires std::predicate<Compare, const T&, const T&>
+class indexed_priority_queue {
+public:
+    using value_type = T;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using handle_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    struct node {
+        T value;
+        handle_type handle;
+    };
+
+    using node_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<node>;
+    using index_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    mystd::vector<node, node_allocator> c;
+    mystd::vector<size_type, index_allocator> pos;
+    mystd::vector<handle_type, index_allocator> free_handles;
+    Compare comp = Compare();
+
+    void place( size_type index, node&& n ) {
+        pos[n.handle] = index;
+        c[index] = std::move(n);
+    }
+
+    void sift_up( size_type index ) {
+        node n = std::move(c[index]);
+        while (index > 0) {
+            size_type parent = (index - 1) / 2;
+            if (!comp(c[parent].value, n.value)) break;
+            place(index, std::move(c[parent]));
+            index = parent;
+        }
+        place(index, std::move(n));
+    }
+
+    void sift_down( size_type index ) {
+        node n = std::move(c[index]);
+        size_type size = c.size();
+        while (true) {
+            size_type child = 2 * index + 1;
+            if (child >= size) break;
+            if (child + 1 < size && comp(c[child].value, c[child + 1].value)) ++child;
+            if (!comp(n.value, c[child].value)) break;
+            place(index, std::move(c[child]));
+            index = child;
+        }
+        place(index, std::move(n));
+    }
+
+    // Stores value in the node of h and restores the heap around it.
+    template< class V >
+    void change( handle_type h, V&& value ) {
+        checked(h);
+        size_type index = pos[h];
+        bool towards_top = comp(c[index].value, value);
+        c[index].value = std::forward<V>(value);
+        if (towards_top) sift_up(index);
+        else sift_down(index);
+    }
+
+    void sift( size_type index ) {
+        if (index > 0 && comp(c[(index - 1) / 2].value, c[index].value)) sift_up(index);
+        else sift_down(index);
+    }
+
+    handle_type acquire_handle() {
+        if (!free_handles.empty()) {
+            handle_type h = free_handles.back();
+            free_handles.pop_back();
+            return h;
+        }
+        pos.push_back(npos);
+        return pos.size() - 1;
+    }
+
+    // Gives back a handle from acquire_handle() that was never used. Cannot throw: it only returns
+    // the room acquire_handle() took from pos or free_handles.
+    void release_handle( handle_type h ) noexcept {
+        if (h + 1 == pos.size()) pos.pop_back();
+        else free_handles.push_back(h);
+    }
+
+    void remove_at( size_type index ) {
+        handle_type h = c[index].handle;
+        free_handles.push_back(h);
+        pos[h] = npos;
+        if (index + 1 != c.size()) {
+            place(index, std::move(c.back()));
+            c.pop_back();
+            sift(index);
+        } else {
+            c.pop_back();
+        }
+    }
+
+    const node& checked( handle_type h ) const {
+        if (!contains(h)) throw std::out_of_range("indexed_priority_queue");
+        return c[pos[h]];
+    }
+
+public:
+    indexed_priority_queue() : indexed_priority_queue(Compare()) {}
+
+    explicit indexed_priority_queue( const Compare& compare ) : comp(compare) {}
+
+    explicit indexed_priority_queue( const Allocator& alloc ) : c(node_allocator(alloc)), pos(index_allocator(alloc)), free_handles(index_allocator(alloc)), comp(Compare()) {}
+
+    indexed_priority_queue( const Compare& compare, const Allocator& alloc ) : c(node_allocator(alloc)), pos(index_allocator(alloc)), free_handles(index_allocator(alloc)), comp(compare) {}
+
+    indexed_priority_queue( const indexed_priority_queue& other ) = default;
+
+    indexed_priority_queue( indexed_priority_queue&& other ) noexcept = default;
+
+    ~indexed_priority_queue() = default;
+
+    indexed_priority_queue& operator=( const indexed_priority_queue& other ) = default;
+
+    indexed_priority_queue& operator=( indexed_priority_queue&& other ) noexcept = default;
+
+    const_reference top() const {
+        return c.front().value;
+    }
+
+    handle_type top_handle() const {
+        return c.front().handle;
+    }
+
+    bool empty() const {
+        return c.empty();
+    }
+
+    size_type size() const {
+        return c.size();
+    }
+
+    bool contains( handle_type h ) const {
+        return h < pos.size() && pos[h] != npos;
+    }
+
+    const_reference operator[]( handle_type h ) const {
+        return c[pos[h]].value;
+    }
+
+    const_reference at( handle_type h ) const {
+        return checked(h).value;
+    }
+
+    void reserve( size_type n ) {
+        c.reserve(n);
+        pos.reserve(n);
+    }
+
+    handle_type push( const value_type& value ) {
+        return emplace(value);
+    }
+
+    handle_type push( value_type&& value ) {
+        return emplace(std::move(value));
+    }
+
+    template< class... Args >
+    handle_type emplace( Args&&... args ) {
+        node n{ T(std::forward<Args>(args)...), npos };
+        handle_type h = acquire_handle();
+        n.handle = h;
+        try {
+            c.push_back(std::move(n));
+        } catch (...) {
+            release_handle(h);
+            throw;
+        }
+        pos[h] = c.size() - 1;
+        sift_up(c.size() - 1);
+        return h;
+    }
+
+    void pop() {
+        remove_at(0);
+    }
+
+    void erase( handle_type h ) {
+        checked(h);
+        remove_at(pos[h]);
+    }
+
+    void update( handle_type h, const value_type& value ) {
+        change(h, value);
+    }
+
+    void update( handle_type h, value_type&& value ) {
+        change(h, std::move(value));
+    }
+
+    void increase_key( handle_type h, const value_type& value ) {
+        change(h, value);
+    }
+
+    void increase_key( handle_type h, value_type&& value ) {
+        change(h, std::move(value));
+    }
+
+    void decrease_key( handle_type h, const value_type& value ) {
+        change(h, value);
+    }
+
+    void decrease_key( handle_type h, value_type&& value ) {
+        change(h, std::move(value));
+    }
+
+    void clear() noexcept {
+        c.clear();
+        pos.clear();
+        free_handles.clear();
+    }
+
+    void swap( indexed_priority_queue& other ) noexcept( noexcept(std::swap(c, other.c)) && noexcept(std::swap(comp, other.comp)) ) {
+        std::swap(c, other.c);
+        std::swap(pos, other.pos);
+        std::swap(free_handles, other.free_handles);
+        std::swap(comp, other.comp);
+    }
+};
+
+template< class T, class Compare, class Allocator >
+requires std::predicate<Compare, const T&, const T&>
+struct is_trivially_relocatable<mystd::indexed_priority_queue<T, Compare, Allocator>> : std::conjunction<is_trivially_relocatable<Allocator>, is_trivially_relocatable<Compare>> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, class Compare, class Allocator >
+void swap( mystd::indexed_priority_queue<T, Compare, Allocator>& lhs, mystd::indexed_priority_queue<T, Compare, Allocator>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,36 @@
+#pragma once // is_trivially_relocatable.hpp
+
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace mystd {
+
+// A type is trivially relocatable when moving an object to new storage and ending the lifetime of
+// the source is the same as copying its bytes, so containers may relocate whole buffers with one
+// memcpy/memmove and skip the destructor calls. Trivially copyable types qualify; other types opt in
+// by specializing the trait. Types that point into themselves must not, which rules out
+// libstdc++'s std::string (its small buffer) and std::list (its sentinel node).
+template< class T >
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template< class T >
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template< class T, class D >
+struct is_trivially_relocatable< std::unique_ptr<T, D> > : is_trivially_relocatable<D> {};
+
+template< class T >
+struct is_trivially_relocatable< std::shared_ptr<T> > : std::true_type {};
+
+template< class T >
+struct is_trivially_relocatable< std::weak_ptr<T> > : std::true_type {};
+
+template< class T >
+struct is_trivially_relocatable< std::optional<T> > : is_trivially_relocatable<T> {};
+
+template< class T, class U >
+struct is_trivially_relocatable< std::pair<T, U> > : std::conjunction<is_trivially_relocatable<T>, is_trivially_relocatable<U>> {};
+
+} // namespace mystd
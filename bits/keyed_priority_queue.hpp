@@ -0,0 +1,220 @@
+#pragma once // keyed_priority_queue.hpp
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include "allocator.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Priority queue of (key, payload) elements ordered by key alone, for large payloads behind small
+// keys. The heap is two parallel arrays, the keys and a 32-bit slot index per key, so sifts only
+// move keys and indices; payloads are built in place in a separate array of optional slots, moved
+// only by pop_value() and destroyed by pop. Slots freed by pop are reused by later pushes.
+template<class Key, class Payload, class Compare = std::less<Key>, class Allocator = mystd::allocator<Payload>>
+requires std::predicate<Compare, const Key&, const Key&>
+class keyed_priority_queue {
+public:
+    using key_type = Key;
+    using payload_type = Payload;
+    using value_type = std::pair<Key, Payload>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+
+protected:
+    using key_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<Key>;
+    using slot_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+    using payload_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<std::optional<Payload>>;
+
+    mystd::vector<Key, key_allocator> keys;
+    mystd::vector<std::uint32_t, slot_allocator> slots;
+    mystd::vector<std::optional<Payload>, payload_allocator> payloads;
+    mystd::vector<std::uint32_t, slot_allocator> free_slots;
+    Compare comp = Compare();
+
+    void sift_up( size_type hole, Key key, std::uint32_t slot ) {
+        while (hole > 0) {
+            size_type parent = (hole - 1) / 2;
+            if (!comp(keys[parent], key)) break;
+            keys[hole] = std::move(keys[parent]);
+            slots[hole] = slots[parent];
+            hole = parent;
+        }
+        keys[hole] = std::move(key);
+        slots[hole] = slot;
+    }
+
+    // Bottom-up sift of the last key into the root hole, as in __adjust_heap.
+    void sift_down_from_root() {
+        size_type size = keys.size() - 1;
+        Key key = std::move(keys[size]);
+        std::uint32_t slot = slots[size];
+        size_type hole = 0;
+        size_type child = 2;
+        while (child < size) {
+            if (comp(keys[child], keys[child - 1])) --child;
+            keys[hole] = std::move(keys[child]);
+            slots[hole] = slots[child];
+            hole = child;
+            child = 2 * child + 2;
+        }
+        if (child == size) {
+            keys[hole] = std::move(keys[child - 1]);
+            slots[hole] = slots[child - 1];
+            hole = child - 1;
+        }
+        keys.pop_back();
+        slots.pop_back();
+        sift_up(hole, std::move(key), slot);
+    }
+
+    template< class... Args >
+    std::uint32_t store( Args&&... args ) {
+        if (!free_slots.empty()) {
+            std::uint32_t slot = free_slots.back();
+            payloads[slot].emplace(std::forward<Args>(args)...);
+            free_slots.pop_back();
+            return slot;
+        }
+        if (payloads.size() >= std::numeric_limits<std::uint32_t>::max()) throw std::length_error("keyed_priority_queue");
+        payloads.emplace_back(std::nullopt);
+        try { payloads.back().emplace(std::forward<Args>(args)...); }
+        catch (...) {
+            payloads.pop_back();
+            throw;
+        }
+        return static_cast<std::uint32_t>(payloads.size() - 1);
+    }
+
+    void insert( Key key, std::uint32_t slot ) {
+        try {
+            keys.push_back(key);
+            slots.push_back(slot);
+        } catch (...) {
+            if (keys.size() > slots.size()) keys.pop_back();
+            payloads[slot].reset();
+            free_slots.push_back(slot);
+            throw;
+        }
+        sift_up(keys.size() - 1, std::move(key), slot);
+    }
+
+    void remove_top() {
+        free_slots.push_back(slots.front());
+        payloads[slots.front()].reset();
+        if (keys.size() > 1) {
+            sift_down_from_root();
+        } else {
+            keys.pop_back();
+            slots.pop_back();
+        }
+    }
+
+public:
+    keyed_priority_queue() : keyed_priority_queue(Compare()) {}
+
+    explicit keyed_priority_queue( const Compare& compare ) : comp(compare) {}
+
+    explicit keyed_priority_queue( const Allocator& alloc ) : keys(key_allocator(alloc)), slots(slot_allocator(alloc)), payloads(payload_allocator(alloc)), free_slots(slot_allocator(alloc)), comp(Compare()) {}
+
+    keyed_priority_queue( const Compare& compare, const Allocator& alloc ) : keys(key_allocator(alloc)), slots(slot_allocator(alloc)), payloads(payload_allocator(alloc)), free_slots(slot_allocator(alloc)), comp(compare) {}
+
+    keyed_priority_queue( const keyed_priority_queue& other ) = default;
+
+    keyed_priority_queue( keyed_priority_queue&& other ) noexcept = default;
+
+    ~keyed_priority_queue() = default;
+
+    keyed_priority_queue& operator=( const keyed_priority_queue& other ) = default;
+
+    keyed_priority_queue& operator=( keyed_priority_queue&& other ) noexcept = default;
+
+    const key_type& top_key() const {
+        return keys.front();
+    }
+
+    const payload_type& top() const {
+        return *payloads[slots.front()];
+    }
+
+    payload_type& top() {
+        return *payloads[slots.front()];
+    }
+
+    bool empty() const {
+        return keys.empty();
+    }
+
+    size_type size() const {
+        return keys.size();
+    }
+
+    void reserve( size_type new_cap ) {
+        keys.reserve(new_cap);
+        slots.reserve(new_cap);
+        payloads.reserve(new_cap);
+    }
+
+    void push( const key_type& key, const payload_type& payload ) {
+        insert(key, store(payload));
+    }
+
+    void push( const key_type& key, payload_type&& payload ) {
+        insert(key, store(std::move(payload)));
+    }
+
+    template< class... Args >
+    void emplace( const key_type& key, Args&&... args ) {
+        insert(key, store(std::forward<Args>(args)...));
+    }
+
+    void pop() {
+        remove_top();
+    }
+
+    value_type pop_value() {
+        value_type value(keys.front(), std::move(*payloads[slots.front()]));
+        remove_top();
+        return value;
+    }
+
+    void clear() noexcept {
+        keys.clear();
+        slots.clear();
+        payloads.clear();
+        free_slots.clear();
+    }
+
+    void swap( keyed_priority_queue& other ) noexcept( noexcept(std::swap(comp, other.comp)) ) {
+        keys.swap(other.keys);
+        slots.swap(other.slots);
+        payloads.swap(other.payloads);
+        free_slots.swap(other.free_slots);
+        std::swap(comp, other.comp);
+    }
+};
+
+template< class Key, class Payload, class Compare, class Allocator >
+requires std::predicate<Compare, const Key&, const Key&>
+struct is_trivially_relocatable<mystd::keyed_priority_queue<Key, Payload, Compare, Allocator>> : std::conjunction<is_trivially_relocatable<Allocator>, is_trivially_relocatable<Compare>> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class Key, class Payload, class Compare, class Allocator >
+requires std::predicate<Compare, const Key&, const Key&>
+void swap( mystd::keyed_priority_queue<Key, Payload, Compare, Allocator>& lhs, mystd::keyed_priority_queue<Key, Payload, Compare, Allocator>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,264 @@
+#pragma once // minmax_heap.hpp
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include "allocator.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Double-ended priority queue in a single array (Atkinson et al. min-max heap). Even levels are
+// ordered as min-heaps and odd levels as max-heaps, so the minimum is at the root and the maximum
+// is one of its children; push, pop_min and pop_max are O(log n).
+template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>>
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+class minmax_heap {
+public:
+    using container_type = Container;
+    using value_compare = Compare;
+    using value_type = typename Container::value_type;
+    using size_type = typename Container::size_type;
+    using reference = typename Container::reference;
+    using const_reference = typename Container::const_reference;
+
+protected:
+    Container c = Container();
+    Compare comp = Compare();
+
+    static bool on_min_level( size_type index ) {
+        return (std::bit_width(index + 1) & 1) == 1;
+    }
+
+    template< bool Max >
+    bool before( const value_type& lhs, const value_type& rhs ) const {
+        if constexpr (Max) return comp(rhs, lhs);
+        else return comp(lhs, rhs);
+    }
+
+    template< bool Max >
+    void push_up( size_type index ) {
+        value_type value = std::move(c[index]);
+        while (index > 2) {
+            size_type grandparent = ((index - 1) / 2 - 1) / 2;
+            if (!before<Max>(value, c[grandparent])) break;
+            c[index] = std::move(c[grandparent]);
+            index = grandparent;
+        }
+        c[index] = std::move(value);
+    }
+
+    void push_up( size_type index ) {
+        if (index == 0) return;
+        size_type parent = (index - 1) / 2;
+        if (on_min_level(index)) {
+            if (comp(c[parent], c[index])) {
+                std::swap(c[parent], c[index]);
+                push_up<true>(parent);
+            } else push_up<false>(index);
+        } else {
+            if (comp(c[index], c[parent])) {
+                std::swap(c[parent], c[index]);
+                push_up<false>(parent);
+            } else push_up<true>(index);
+        }
+    }
+
+    template< bool Max >
+    void trickle_down( size_type index ) {
+        size_type size = c.size();
+        while (true) {
+            size_type child = 2 * index + 1;
+            if (child >= size) return;
+            size_type best = child;
+            if (child + 1 < size && before<Max>(c[child + 1], c[best])) best = child + 1;
+            for (size_type g = 2 * child + 1; g < size && g <= 2 * child + 4; ++g) {
+                if (before<Max>(c[g], c[best])) best = g;
+            }
+            if (!before<Max>(c[best], c[index])) return;
+            std::swap(c[best], c[index]);
+            if (best <= child + 1) return;
+            size_type parent = (best - 1) / 2;
+            if (before<Max>(c[parent], c[best])) std::swap(c[parent], c[best]);
+            index = best;
+        }
+    }
+
+    void trickle_down( size_type index ) {
+        if (on_min_level(index)) trickle_down<false>(index);
+        else trickle_down<true>(index);
+    }
+
+    void make_heap() {
+        for (size_type i = c.size() / 2; i-- > 0; ) trickle_down(i);
+    }
+
+    size_type max_index() const {
+        if (c.size() <= 2) return c.size() - 1;
+        return comp(c[1], c[2]) ? 2 : 1;
+    }
+
+    void erase_at( size_type index ) {
+        if (index + 1 != c.size()) {
+            c[index] = std::move(c.back());
+            c.pop_back();
+            trickle_down(index);
+        } else {
+            c.pop_back();
+        }
+    }
+
+public:
+    minmax_heap() : minmax_heap(Compare(), Container()) {}
+
+    explicit minmax_heap( const Compare& compare ) : minmax_heap(compare, Container()) {}
+
+    minmax_heap( const Compare& compare, const Container& cont ) : c(cont), comp(compare) {
+        make_heap();
+    }
+
+    minmax_heap( const Compare& compare, Container&& cont ) : c(std::move(cont)), comp(compare) {
+        make_heap();
+    }
+
+    minmax_heap( const minmax_heap& other ) : c(other.c), comp(other.comp) {}
+
+    minmax_heap( minmax_heap&& other ) noexcept : c(std::move(other.c)), comp(std::move(other.comp)) {}
+
+    template< std::input_iterator InputIt >
+    requires requires(InputIt first, InputIt last) { { Container(first, last) }; }
+    minmax_heap( InputIt first, InputIt last, const Compare& compare = Compare() ) : c(first, last), comp(compare) {
+        make_heap();
+    }
+
+    template< class Alloc >
+    explicit minmax_heap( const Alloc& alloc ) : c(alloc), comp(Compare()) {}
+
+    template< class Alloc >
+    minmax_heap( const Compare& compare, const Alloc& alloc ) : c(alloc), comp(compare) {}
+
+    template< class Alloc >
+    minmax_heap( const Compare& compare, const Container& cont, const Alloc& alloc ) : c(cont, alloc), comp(compare) {
+        make_heap();
+    }
+
+    template< class Alloc >
+    minmax_heap( const Compare& compare, Container&& cont, const Alloc& alloc ) : c(std::move(cont), alloc), comp(compare) {
+        make_heap();
+    }
+
+    template< class Alloc >
+    minmax_heap( const minmax_heap& other, const Alloc& alloc ) : c(other.c, alloc), comp(other.comp) {}
+
+    template< class Alloc >
+    minmax_heap( minmax_heap&& other, const Alloc& alloc ) : c(std::move(other.c), alloc), comp(std::move(other.comp)) {}
+
+    template< std::input_iterator InputIt, class Alloc >
+    requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
+    minmax_heap( InputIt first, InputIt last, const Alloc& alloc ) : c(alloc), comp(Compare()) {
+        c.insert(c.end(), first, last);
+        make_heap();
+    }
+
+    template< std::input_iterator InputIt, class Alloc >
+    requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
+    minmax_heap( InputIt first, InputIt last, const Compare& compare, const Alloc& alloc ) : c(alloc), comp(compare) {
+        c.insert(c.end(), first, last);
+        make_heap();
+    }
+
+    ~minmax_heap() = default;
+
+    minmax_heap& operator=( const minmax_heap& other ) {
+        if (this != &other) {
+            c = other.c;
+            comp = other.comp;
+        }
+        return *this;
+    }
+
+    minmax_heap& operator=( minmax_heap&& other ) noexcept {
+        if (this != &other) {
+            c = std::move(other.c);
+            comp = std::move(other.comp);
+        }
+        return *this;
+    }
+
+    const_reference min() const {
+        return c.front();
+    }
+
+    const_reference max() const {
+        return c[max_index()];
+    }
+
+    bool empty() const {
+        return c.empty();
+    }
+
+    size_type size() const {
+        return c.size();
+    }
+
+    void push( const value_type& value ) {
+        c.push_back(value);
+        push_up(c.size() - 1);
+    }
+
+    void push( value_type&& value ) {
+        c.push_back(std::move(value));
+        push_up(c.size() - 1);
+    }
+
+    template< class... Args >
+    void emplace( Args&&... args ) {
+        c.emplace_back(std::forward<Args>(args)...);
+        push_up(c.size() - 1);
+    }
+
+    void pop_min() {
+        erase_at(0);
+    }
+
+    void pop_max() {
+        erase_at(max_index());
+    }
+
+    void swap( minmax_heap& other ) noexcept( noexcept(std::swap(c, other.c)) && noexcept(std::swap(comp, other.comp)) ) {
+        std::swap(c, other.c);
+        std::swap(comp, other.comp);
+    }
+};
+
+template< class Comp, class Container >
+minmax_heap( Comp, Container ) -> minmax_heap<typename Container::value_type, Container, Comp>;
+
+template< std::input_iterator InputIt, class Comp = std::less<typename std::iterator_traits<InputIt>::value_type>, class Container = mystd::vector<typename std::iterator_traits<InputIt>::value_type> >
+minmax_heap( InputIt, InputIt, Comp = Comp(), Container = Container() ) -> minmax_heap<typename std::iterator_traits<InputIt>::value_type, Container, Comp>;
+
+template< class T, class Container, class Compare, class Alloc >
+requires std::predicate<Compare, const T&, const T&>
+struct uses_allocator<mystd::minmax_heap<T, Container, Compare>, Alloc> : std::uses_allocator<Container, Alloc> {};
+
+template< class T, class Container, class Compare >
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+struct is_trivially_relocatable<mystd::minmax_heap<T, Container, Compare>> : std::conjunction<is_trivially_relocatable<Container>, is_trivially_relocatable<Compare>> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, class Container, class Compare >
+requires std::predicate<Compare, const T&, const T&>
+constexpr void swap( mystd::minmax_heap<T, Container, Compare>& lhs, mystd::minmax_heap<T, Container, Compare>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,138 @@
+#pragma once // multiqueue.hpp
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "priority_queue.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Relaxed concurrent priority queue (MultiQueue): factor * threads shards, each a mystd::priority_queue
+// behind its own mutex on its own cache line. push goes to a random shard; try_pop samples two
+// shards and pops from the one with the better top (power of two choices). Locks are only ever
+// try-locked on the fast path, so a contended shard is skipped rather than waited on. Ordering
+// is approximate: try_pop returns an element close to, but not necessarily, the global top.
+template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>>
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+class multiqueue {
+public:
+    using value_type = typename Container::value_type;
+    using value_compare = Compare;
+    using size_type = std::size_t;
+
+protected:
+    // items mirrors pq.size(); it is written under the lock but read without it, so empty shards
+    // are skipped without touching their locks.
+    struct alignas(64) shard {
+        std::mutex lock;
+        mystd::priority_queue<T, Container, Compare> pq;
+        std::atomic<size_type> items{ 0 };
+    };
+
+    std::unique_ptr<shard[]> shards;
+    size_type nshards;
+    Compare comp;
+    alignas(64) std::atomic<size_type> count{ 0 };
+
+    static std::uint64_t random() {
+        thread_local std::uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    shard& random_shard() {
+        return shards[random() % nshards];
+    }
+
+    // Pops the top of s, whose lock the caller holds.
+    std::optional<value_type> pop_from( shard& s ) {
+        std::optional<value_type> value(s.pq.pop_value());
+        s.items.store(s.pq.size(), std::memory_order_relaxed);
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return value;
+    }
+
+public:
+    explicit multiqueue( size_type threads = std::thread::hardware_concurrency(), size_type factor = 2, const Compare& compare = Compare() ) : nshards(std::max<size_type>(threads, 1) * std::max<size_type>(factor, 1)), comp(compare) {
+        shards = std::make_unique<shard[]>(nshards);
+        for (size_type i = 0; i < nshards; ++i) shards[i].pq = mystd::priority_queue<T, Container, Compare>(comp);
+    }
+
+    multiqueue( const multiqueue& ) = delete;
+
+    multiqueue& operator=( const multiqueue& ) = delete;
+
+    ~multiqueue() = default;
+
+    // Approximate while other threads are pushing or popping.
+    size_type size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type shard_count() const {
+        return nshards;
+    }
+
+    void push( const value_type& value ) {
+        emplace(value);
+    }
+
+    void push( value_type&& value ) {
+        emplace(std::move(value));
+    }
+
+    template< class Arg >
+    void emplace( Arg&& arg ) {
+        for (size_type attempt = 0; ; ++attempt) {
+            shard& s = random_shard();
+            std::unique_lock<std::mutex> guard(s.lock, std::try_to_lock);
+            if (!guard && attempt < nshards) continue;
+            if (!guard) guard.lock();
+            s.pq.emplace(std::forward<Arg>(arg));
+            s.items.store(s.pq.size(), std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // Returns std::nullopt without taking any lock while the queue looks empty.
+    std::optional<value_type> try_pop() {
+        for (size_type attempt = 0; attempt < 2 * nshards; ++attempt) {
+            if (count.load(std::memory_order_relaxed) == 0) return std::nullopt;
+            shard& a = random_shard();
+            shard& b = random_shard();
+            std::unique_lock<std::mutex> guard_a;
+            std::unique_lock<std::mutex> guard_b;
+            if (a.items.load(std::memory_order_relaxed) != 0) guard_a = std::unique_lock<std::mutex>(a.lock, std::try_to_lock);
+            if (&a != &b && b.items.load(std::memory_order_relaxed) != 0) guard_b = std::unique_lock<std::mutex>(b.lock, std::try_to_lock);
+            shard* best = guard_a && !a.pq.empty() ? &a : nullptr;
+            if (guard_b && !b.pq.empty() && (!best || comp(best->pq.top(), b.pq.top()))) best = &b;
+            if (!best) continue;
+            return pop_from(*best);
+        }
+        for (size_type i = 0; i < nshards; ++i) {
+            if (count.load(std::memory_order_relaxed) == 0) return std::nullopt;
+            if (shards[i].items.load(std::memory_order_relaxed) == 0) continue;
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            if (!shards[i].pq.empty()) return pop_from(shards[i]);
+        }
+        return std::nullopt;
+    }
+};
+
+} // namespace mystd
@@ -0,0 +1,282 @@
+#pragma once // pairing_heap.hpp
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include "allocator.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Node-based meldable priority queue (pairing heap) with the priority_queue interface: push and
+// meld are O(1), pop is amortized O(log n) using two-pass pairing. The template parameters line up
+// with priority_queue<T, Container, Compare> so either can be plugged into a
+// template<class, class, class> class parameter. No Container is ever built: only its
+// allocator_type is used, rebound through mystd::allocator_traits to allocate the nodes, so a
+// pooling allocator can serve them.
+template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>>
+requires std::predicate<Compare, const T&, const T&>
+class pairing_heap {
+public:
+    using value_type = T;
+    using allocator_type = typename Container::allocator_type;
+    using value_compare = Compare;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+protected:
+    struct node {
+        T value;
+        node* child;
+        node* sibling;
+    };
+
+    using node_allocator = typename mystd::allocator_traits<allocator_type>::template rebind_alloc<node>;
+    using node_traits = mystd::allocator_traits<node_allocator>;
+
+    [[no_unique_address]] node_allocator alloc;
+    Compare comp = Compare();
+    node* root = nullptr;
+    size_type sz = 0;
+
+    template< class... Args >
+    node* create( Args&&... args ) {
+        node* n = node_traits::allocate(alloc, 1);
+        try { node_traits::construct(alloc, n, node{ T(std::forward<Args>(args)...), nullptr, nullptr }); }
+        catch (...) {
+            node_traits::deallocate(alloc, n, 1);
+            throw;
+        }
+        return n;
+    }
+
+    void destroy( node* n ) {
+        node_traits::destroy(alloc, n);
+        node_traits::deallocate(alloc, n, 1);
+    }
+
+    node* link( node* a, node* b ) {
+        if (comp(a->value, b->value)) std::swap(a, b);
+        b->sibling = a->child;
+        a->child = b;
+        return a;
+    }
+
+    void insert( node* n ) {
+        root = root ? link(root, n) : n;
+        ++sz;
+    }
+
+    // Splices each node's children in front of its siblings so the whole tree is walked as one list.
+    template< class Fn >
+    static void flatten( node* n, Fn fn ) {
+        while (n) {
+            if (node* c = n->child) {
+                node* tail = c;
+                while (tail->sibling) tail = tail->sibling;
+                tail->sibling = n->sibling;
+                n->sibling = c;
+                n->child = nullptr;
+            }
+            node* next = n->sibling;
+            fn(n);
+            n = next;
+        }
+    }
+
+    // Copies every element of other in; if a copy throws, the heap is left empty.
+    void copy_from( const pairing_heap& other ) {
+        try {
+            mystd::vector<const node*> stack;
+            if (other.root) stack.push_back(other.root);
+            while (!stack.empty()) {
+                const node* n = stack.back();
+                stack.pop_back();
+                insert(create(n->value));
+                if (n->sibling) stack.push_back(n->sibling);
+                if (n->child) stack.push_back(n->child);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    void remove_root() {
+        node* old = root;
+        node* merged = nullptr;
+        for (node* list = old->child; list; ) {
+            node* a = list;
+            node* b = a->sibling;
+            if (!b) {
+                a->sibling = merged;
+                merged = a;
+                break;
+            }
+            list = b->sibling;
+            a->sibling = b->sibling = nullptr;
+            node* m = link(a, b);
+            m->sibling = merged;
+            merged = m;
+        }
+        node* result = nullptr;
+        while (merged) {
+            node* next = merged->sibling;
+            merged->sibling = nullptr;
+            result = result ? link(result, merged) : merged;
+            merged = next;
+        }
+        root = result;
+        --sz;
+        destroy(old);
+    }
+
+public:
+    pairing_heap() : pairing_heap(Compare()) {}
+
+    explicit pairing_heap( const Compare& compare ) : alloc(), comp(compare) {}
+
+    explicit pairing_heap( const allocator_type& alloc_ ) : alloc(alloc_), comp(Compare()) {}
+
+    pairing_heap( const Compare& compare, const allocator_type& alloc_ ) : alloc(alloc_), comp(compare) {}
+
+    template< std::input_iterator InputIt >
+    pairing_heap( InputIt first, InputIt last, const Compare& compare = Compare(), const allocator_type& alloc_ = allocator_type() ) : alloc(alloc_), comp(compare) {
+        try {
+            for (; first != last; ++first) push(*first);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    pairing_heap( const pairing_heap& other ) : alloc(node_traits::select_on_container_copy_construction(other.alloc)), comp(other.comp) {
+        copy_from(other);
+    }
+
+    pairing_heap( const pairing_heap& other, const allocator_type& alloc_ ) : alloc(alloc_), comp(other.comp) {
+        copy_from(other);
+    }
+
+    pairing_heap( pairing_heap&& other ) noexcept : alloc(std::move(other.alloc)), comp(std::move(other.comp)), root(std::exchange(other.root, nullptr)), sz(std::exchange(other.sz, 0)) {}
+
+    ~pairing_heap() {
+        clear();
+    }
+
+    pairing_heap& operator=( const pairing_heap& other ) {
+        if (this != &other) {
+            clear();
+            if constexpr (node_traits::propagate_on_container_copy_assignment::value) alloc = other.alloc;
+            comp = other.comp;
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    pairing_heap& operator=( pairing_heap&& other ) noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value) {
+        if (this != &other) {
+            clear();
+            comp = std::move(other.comp);
+            if constexpr (node_traits::propagate_on_container_move_assignment::value) alloc = std::move(other.alloc);
+            meld(other);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+
+    const_reference top() const {
+        return root->value;
+    }
+
+    bool empty() const {
+        return sz == 0;
+    }
+
+    size_type size() const {
+        return sz;
+    }
+
+    void push( const value_type& value ) {
+        insert(create(value));
+    }
+
+    void push( value_type&& value ) {
+        insert(create(std::move(value)));
+    }
+
+    template< class... Args >
+    reference emplace( Args&&... args ) {
+        node* n = create(std::forward<Args>(args)...);
+        insert(n);
+        return n->value;
+    }
+
+    void pop() {
+        remove_root();
+    }
+
+    value_type pop_value() {
+        value_type value = std::move(root->value);
+        remove_root();
+        return value;
+    }
+
+    // Takes over every element of other, leaving it empty. O(1) when the allocators can free each
+    // other's nodes; otherwise the elements are moved over one by one.
+    void meld( pairing_heap& other ) {
+        if (this == &other || !other.root) return;
+        if constexpr (!node_traits::is_always_equal::value) {
+            if (!(alloc == other.alloc)) {
+                while (!other.empty()) push(other.pop_value());
+                return;
+            }
+        }
+        root = root ? link(root, other.root) : other.root;
+        sz += other.sz;
+        other.root = nullptr;
+        other.sz = 0;
+    }
+
+    void meld( pairing_heap&& other ) {
+        meld(other);
+    }
+
+    void clear() noexcept {
+        flatten(root, [this]( node* n ) { destroy(n); });
+        root = nullptr;
+        sz = 0;
+    }
+
+    void swap( pairing_heap& other ) noexcept( noexcept(std::swap(comp, other.comp)) ) {
+        if constexpr (node_traits::propagate_on_container_swap::value) std::swap(alloc, other.alloc);
+        std::swap(comp, other.comp);
+        std::swap(root, other.root);
+        std::swap(sz, other.sz);
+    }
+};
+
+template< class T, class Container, class Compare >
+requires std::predicate<Compare, const T&, const T&>
+struct is_trivially_relocatable<mystd::pairing_heap<T, Container, Compare>> : std::conjunction<is_trivially_relocatable<typename Container::allocator_type>, is_trivially_relocatable<Compare>> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, class Container, class Compare >
+requires std::predicate<Compare, const T&, const T&>
+void swap( mystd::pairing_heap<T, Container, Compare>& lhs, mystd::pairing_heap<T, Container, Compare>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -1,5 +1,7 @@
 #pragma once // priority_queue.hpp
 
+#include <algorithm>
+#include <bit>
 #include <compare>
 #include <concepts>
 #include <cstddef>
@@ -7,14 +9,18 @@
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <ranges>
 #include <utility>
 #include <type_traits>
 #include "algorithm-heap.hpp"
+#include "is_trivially_relocatable.hpp"
 #include "vector.hpp"
 
 namespace mystd {
-template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>>
-requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+// Stats = mystd::heap_stats counts the comparisons, moves and sift depth of every heap operation
+// and their latencies, readable through stats(); the default no_heap_stats compiles all of it out.
+template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>, std::size_t Arity = 2, class Stats = mystd::no_heap_stats>
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&> && (Arity >= 2) && __heap_stats_policy<Stats>
 class priority_queue {
 public:
     using container_type = Container;
@@ -23,10 +29,37 @@ public:
     using size_type = typename Container::size_type;
     using reference = typename Container::reference;
     using const_reference = typename Container::const_reference;
+    using stats_type = Stats;
+    static constexpr std::size_t arity = Arity;
 
 protected:
     Container c = Container();
     Compare comp = Compare();
+    [[no_unique_address]] Stats stat = Stats();
+
+    void heapify() {
+        mystd::__instrumented(stat, heap_op::make, comp, [this]( auto& cmp ) { mystd::make_heap<Arity>(c.begin(), c.end(), cmp); });
+    }
+
+    void push_heap_to( typename Container::iterator last ) {
+        mystd::__instrumented(stat, heap_op::push, comp, [this, last]( auto& cmp ) { mystd::push_heap<Arity>(c.begin(), last, cmp); });
+    }
+
+    void pop_heap_from( typename Container::iterator last ) {
+        mystd::__instrumented(stat, heap_op::pop, comp, [this, last]( auto& cmp ) { mystd::pop_heap<Arity>(c.begin(), last, cmp); });
+    }
+
+    // Re-establishes the heap after elements were appended past old_size: sifting each one up costs
+    // up to log n per element, so a large enough batch is cheaper to fold in with a full make_heap.
+    void restore_heap( size_type old_size ) {
+        size_type count = c.size() - old_size;
+        if (count == 0) return;
+        if (count * static_cast<size_type>(std::bit_width(c.size())) >= c.size()) {
+            heapify();
+        } else {
+            for (auto it = c.begin() + old_size + 1; it <= c.end(); ++it) push_heap_to(it);
+        }
+    }
 
 public:
     priority_queue() : priority_queue(Compare(), Container()) {}
@@ -34,35 +67,35 @@ public:
     explicit priority_queue( const Compare& compare ) : priority_queue(compare, Container()) {}
 
     priority_queue( const Compare& compare, const Container& cont ) : c(cont), comp(compare) {
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     priority_queue( const Compare& compare, Container&& cont ) : c(std::move(cont)), comp(compare) {
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
-    priority_queue( const priority_queue& other ) : c(other.c), comp(other.comp) {}
+    priority_queue( const priority_queue& other ) : c(other.c), comp(other.comp), stat(other.stat) {}
 
-    priority_queue( priority_queue&& other ) noexcept : c(std::move(other.c)), comp(std::move(other.comp)) {}
+    priority_queue( priority_queue&& other ) noexcept : c(std::move(other.c)), comp(std::move(other.comp)), stat(std::move(other.stat)) {}
 
     template< std::input_iterator InputIt >
     requires requires(InputIt first, InputIt last) { { Container(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare = Compare() ) : c(first, last), comp(compare) {
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< std::input_iterator InputIt >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare, const Container& cont ) : c(cont), comp(compare) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< std::input_iterator InputIt >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare, Container&& cont ) : c(std::move(cont)), comp(compare) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< class Alloc >
@@ -73,46 +106,46 @@ public:
 
     template< class Alloc >
     priority_queue( const Compare& compare, const Container& cont, const Alloc& alloc ) : c(cont, alloc), comp(compare) {
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< class Alloc >
     priority_queue( const Compare& compare, Container&& cont, const Alloc& alloc ) : c(std::move(cont), alloc), comp(compare) {
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< class Alloc >
-    priority_queue( const priority_queue& other, const Alloc& alloc ) : c(other.c, alloc), comp(other.comp) {}
+    priority_queue( const priority_queue& other, const Alloc& alloc ) : c(other.c, alloc), comp(other.comp), stat(other.stat) {}
 
     template< class Alloc >
-    priority_queue( priority_queue&& other, const Alloc& alloc ) : c(std::move(other.c), alloc), comp(std::move(other.comp)) {}
+    priority_queue( priority_queue&& other, const Alloc& alloc ) : c(std::move(other.c), alloc), comp(std::move(other.comp)), stat(std::move(other.stat)) {}
 
     template< std::input_iterator InputIt, class Alloc >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Alloc& alloc ) : c(alloc), comp(Compare()) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< std::input_iterator InputIt, class Alloc >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare, const Alloc& alloc ) : c(alloc), comp(compare) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< std::input_iterator InputIt, class Alloc >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare, const Container& cont, const Alloc& alloc ) : c(cont, alloc), comp(compare) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     template< std::input_iterator InputIt, class Alloc >
     requires requires(InputIt first, InputIt last) { { std::declval<Container&>().insert(first, last) }; }
     priority_queue( InputIt first, InputIt last, const Compare& compare, Container&& cont, const Alloc& alloc ) : c(std::move(cont), alloc), comp(compare) {
         c.insert(c.end(), first, last);
-        mystd::make_heap(c.begin(), c.end(), comp);
+        heapify();
     }
 
     constexpr ~priority_queue() = default;
@@ -121,6 +154,7 @@ public:
         if (this != &other) {
             c = other.c;
             comp = other.comp;
+            stat = other.stat;
         }
         return *this;
     }
@@ -129,6 +163,7 @@ public:
         if (this != &other) {
             c = std::move(other.c);
             comp = std::move(other.comp);
+            stat = std::move(other.stat);
         }
         return *this;
     }
@@ -147,29 +182,107 @@ public:
 
     void push( const value_type& value ) {
         c.push_back(value);
-        mystd::push_heap(c.begin(), c.end(), comp);
+        push_heap_to(c.end());
     }
 
     void push( value_type&& value ) {
         c.push_back(std::move(value));
-        mystd::push_heap(c.begin(), c.end(), comp);
+        push_heap_to(c.end());
     }
 
     template< class... Args >
     reference emplace( Args&&... args ) {
         c.emplace_back(std::forward<Args>(args)...);
-        mystd::push_heap(c.begin(), c.end(), comp);
+        push_heap_to(c.end());
         return c.back();
     }
 
     void pop() {
-        mystd::pop_heap(c.begin(), c.end(), comp);
+        pop_heap_from(c.end());
         c.pop_back();
     }
 
+    value_type pop_value() {
+        pop_heap_from(c.end());
+        value_type value = std::move(c.back());
+        c.pop_back();
+        return value;
+    }
+
+    value_type extract_top() {
+        return pop_value();
+    }
+
+    template< std::input_iterator InputIt >
+    void push_range( InputIt first, InputIt last ) {
+        size_type old_size = c.size();
+        c.insert(c.end(), first, last);
+        restore_heap(old_size);
+    }
+
+    // Elements of an rvalue range that owns them (not a view, which may refer to another container's
+    // elements) are moved in. Sized ranges reserve once up front, at least doubling the capacity so
+    // that repeated small batches stay amortized.
+    template< std::ranges::input_range R >
+    void push_range( R&& rg ) {
+        constexpr bool steal = !std::is_lvalue_reference_v<R> && !std::ranges::view<std::remove_cvref_t<R>>;
+        size_type old_size = c.size();
+        if constexpr (std::ranges::common_range<R> && !steal) {
+            c.insert(c.end(), std::ranges::begin(rg), std::ranges::end(rg));
+        } else {
+            if constexpr (std::ranges::sized_range<R> && requires { c.reserve(old_size); }) {
+                size_type required = old_size + static_cast<size_type>(std::ranges::size(rg));
+                if (required > c.capacity()) c.reserve(std::max(required, 2 * c.capacity()));
+            }
+            for (auto it = std::ranges::begin(rg); it != std::ranges::end(rg); ++it) {
+                if constexpr (steal) c.push_back(std::ranges::iter_move(it));
+                else c.push_back(*it);
+            }
+        }
+        restore_heap(old_size);
+    }
+
+    template< std::output_iterator<value_type> OutputIt >
+    OutputIt pop_n( size_type n, OutputIt out ) {
+        n = std::min(n, c.size());
+        auto last = c.end();
+        for (size_type i = 0; i < n; ++i, --last) pop_heap_from(last);
+        for (auto it = c.end(); it != last; ) *out++ = std::move(*--it);
+        c.erase(last, c.end());
+        return out;
+    }
+
+    void reserve( size_type n ) {
+        c.reserve(n);
+    }
+
+    size_type capacity() const {
+        return c.capacity();
+    }
+
+    Container extract() {
+        Container cont = std::move(c);
+        c.clear();
+        return cont;
+    }
+
+    void replace( Container&& cont ) {
+        c = std::move(cont);
+        heapify();
+    }
+
+    const Stats& stats() const {
+        return stat;
+    }
+
+    Stats& stats() {
+        return stat;
+    }
+
     void swap( priority_queue& other ) noexcept( noexcept(std::swap(c, other.c)) && noexcept(std::swap(comp, other.comp)) ) {
         std::swap(c, other.c);
         std::swap(comp, other.comp);
+        std::swap(stat, other.stat);
     }
 };
 
@@ -191,17 +304,21 @@ priority_queue( InputIt, InputIt, Comp, Alloc ) -> priority_queue<typename std::
 template< std::input_iterator InputIt, class Comp, class Container, class Alloc >
 priority_queue( InputIt, InputIt, Comp, Container, Alloc ) -> priority_queue<typename Container::value_type, Container, Comp>;
 
-template< class T, class Container, class Compare, class Alloc >
+template< class T, class Container, class Compare, std::size_t Arity, class Stats, class Alloc >
 requires std::predicate<Compare, const T&, const T&>
-struct uses_allocator<mystd::priority_queue<T, Compare, Container>, Alloc> : std::uses_allocator<Container, Alloc> {};
+struct uses_allocator<mystd::priority_queue<T, Container, Compare, Arity, Stats>, Alloc> : std::uses_allocator<Container, Alloc> {};
+
+template< class T, class Container, class Compare, std::size_t Arity, class Stats >
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&> && (Arity >= 2) && __heap_stats_policy<Stats>
+struct is_trivially_relocatable<mystd::priority_queue<T, Container, Compare, Arity, Stats>> : std::conjunction<is_trivially_relocatable<Container>, is_trivially_relocatable<Compare>, is_trivially_relocatable<Stats>> {};
 
 } // namespace mystd
 
 namespace std {
 
-template< class T, class Container, class Compare >
+template< class T, class Container, class Compare, std::size_t Arity, class Stats >
 requires std::predicate<Compare, const T&, const T&>
-constexpr void swap( mystd::priority_queue<T, Container, Compare>& lhs, mystd::priority_queue<T, Container, Compare>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+constexpr void swap( mystd::priority_queue<T, Container, Compare, Arity, Stats>& lhs, mystd::priority_queue<T, Container, Compare, Arity, Stats>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
     lhs.swap(rhs);
 }
 
@@ -0,0 +1,181 @@
+#pragma once // radix_heap.hpp
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "allocator.hpp"
+#include "array.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Monotone min-priority queue over integer keys: no key may be pushed that is smaller than the last
+// key returned by top() or pop(). Bucket i > 0 holds the elements whose key first differs from that
+// last key at bit i - 1, so pop only ever redistributes the lowest non-empty bucket into lower ones,
+// which costs amortized O(log C) bit operations for keys spanning a range of C. Only pop
+// redistributes: top() reads bucket 0, or scans the lowest non-empty bucket without changing it, so
+// const members never modify the heap. Unless NDEBUG is defined, push throws std::invalid_argument on
+// a key below the last one.
+// With a non-void Mapped, elements are std::pair<Key, Mapped> ordered by their first member.
+template<std::integral Key, class Mapped = void, class Allocator = mystd::allocator<std::conditional_t<std::is_void_v<Mapped>, Key, std::pair<Key, Mapped>>>>
+class radix_heap {
+public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::conditional_t<std::is_void_v<Mapped>, Key, std::pair<Key, Mapped>>;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+protected:
+    using ukey_type = std::make_unsigned_t<Key>;
+    static constexpr std::size_t bucket_count = sizeof(Key) * CHAR_BIT + 1;
+
+    mystd::array<mystd::vector<value_type, Allocator>, bucket_count> buckets;
+    ukey_type last = 0;
+    std::uint64_t occupied = 0;
+    size_type sz = 0;
+
+    static const Key& key_of( const value_type& value ) {
+        if constexpr (std::is_void_v<Mapped>) return value;
+        else return value.first;
+    }
+
+    // Signed keys are biased so that unsigned order matches their order.
+    static ukey_type ukey( Key key ) {
+        if constexpr (std::is_signed_v<Key>) return static_cast<ukey_type>(key) ^ (ukey_type(1) << (sizeof(Key) * CHAR_BIT - 1));
+        else return key;
+    }
+
+    std::size_t bucket_of( ukey_type key ) const {
+        return static_cast<std::size_t>(std::bit_width(static_cast<ukey_type>(key ^ last)));
+    }
+
+    void insert( value_type&& value ) {
+        std::size_t b = bucket_of(ukey(key_of(value)));
+        buckets[b].push_back(std::move(value));
+        if (b > 0) occupied |= std::uint64_t(1) << (b - 1);
+    }
+
+    static bool key_less( const value_type& lhs, const value_type& rhs ) {
+        return ukey(key_of(lhs)) < ukey(key_of(rhs));
+    }
+
+    const mystd::vector<value_type, Allocator>& lowest_bucket() const {
+        return buckets[static_cast<std::size_t>(std::countr_zero(occupied)) + 1];
+    }
+
+    // Moves the smallest key into bucket 0 by redistributing the lowest non-empty bucket.
+    void pull() {
+        if (!buckets[0].empty()) return;
+        std::size_t b = static_cast<std::size_t>(std::countr_zero(occupied)) + 1;
+        mystd::vector<value_type, Allocator>& from = buckets[b];
+        last = ukey(key_of(*std::min_element(from.begin(), from.end(), key_less)));
+        occupied &= ~(std::uint64_t(1) << (b - 1));
+        for (value_type& value : from) insert(std::move(value));
+        from.clear();
+    }
+
+    void check( const value_type& value ) const {
+#ifndef NDEBUG
+        if (ukey(key_of(value)) < last) throw std::invalid_argument("radix_heap");
+#else
+        (void)value;
+#endif
+    }
+
+public:
+    radix_heap() = default;
+
+    explicit radix_heap( const Allocator& alloc ) {
+        for (auto& bucket : buckets) bucket = mystd::vector<value_type, Allocator>(alloc);
+    }
+
+    radix_heap( const radix_heap& other ) = default;
+
+    radix_heap( radix_heap&& other ) noexcept = default;
+
+    ~radix_heap() = default;
+
+    radix_heap& operator=( const radix_heap& other ) = default;
+
+    radix_heap& operator=( radix_heap&& other ) noexcept = default;
+
+    const_reference top() const {
+        if (!buckets[0].empty()) return buckets[0].back();
+        const mystd::vector<value_type, Allocator>& from = lowest_bucket();
+        return *std::min_element(from.begin(), from.end(), key_less);
+    }
+
+    key_type top_key() const {
+        return key_of(top());
+    }
+
+    bool empty() const {
+        return sz == 0;
+    }
+
+    size_type size() const {
+        return sz;
+    }
+
+    void push( const value_type& value ) {
+        check(value);
+        insert(value_type(value));
+        ++sz;
+    }
+
+    void push( value_type&& value ) {
+        check(value);
+        insert(std::move(value));
+        ++sz;
+    }
+
+    template< class M = Mapped >
+    requires (!std::is_void_v<M>)
+    void push( const key_type& key, M value ) {
+        push(value_type(key, std::move(value)));
+    }
+
+    void pop() {
+        pull();
+        buckets[0].pop_back();
+        --sz;
+    }
+
+    void clear() noexcept {
+        for (auto& bucket : buckets) bucket.clear();
+        occupied = 0;
+        last = 0;
+        sz = 0;
+    }
+
+    void swap( radix_heap& other ) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i) buckets[i].swap(other.buckets[i]);
+        std::swap(last, other.last);
+        std::swap(occupied, other.occupied);
+        std::swap(sz, other.sz);
+    }
+};
+
+template< std::integral Key, class Mapped, class Allocator >
+struct is_trivially_relocatable<mystd::radix_heap<Key, Mapped, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class Key, class Mapped, class Allocator >
+void swap( mystd::radix_heap<Key, Mapped, Allocator>& lhs, mystd::radix_heap<Key, Mapped, Allocator>& rhs ) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,356 @@
+#pragma once // timing_wheel.hpp
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include "allocator.hpp"
+#include "array.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Hierarchical timing wheel for timeouts (Varghese & Lauck): Levels wheels of 64 slots each, where a
+// slot on level L spans 64^L ticks. A timer lives on the level of the highest 6-bit digit in which its
+// deadline differs from now(), so schedule, reschedule and cancel are O(1) unlinks from intrusive slot
+// lists. advance() jumps straight to the next occupied slot and cascades it one level down, so idle
+// stretches cost nothing. Deadlines more than 64^Levels ticks out wait in an overflow
+// mystd::priority_queue until their window comes up; cancelling one leaves a stale record there that
+// is discarded when reached.
+// Handles carry a generation, so cancelling a timer that already fired or was cancelled is a no-op.
+template<class T, std::size_t Levels = 4, class Allocator = mystd::allocator<T>>
+requires (Levels > 0 && Levels * 6 < 64)
+class timing_wheel {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using time_type = std::uint64_t;
+    using handle_type = std::uint64_t;
+    using batch_type = mystd::vector<T, Allocator>;
+    static constexpr std::size_t levels = Levels;
+    static constexpr std::size_t slots_per_level = 64;
+
+protected:
+    static constexpr std::size_t slot_bits = 6;
+    static constexpr std::size_t wheel_bits = slot_bits * Levels;
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t expired_list = Levels * slots_per_level;
+    static constexpr std::uint32_t overflow_list = expired_list + 1;
+
+    struct entry {
+        std::optional<T> value;
+        time_type deadline = 0;
+        std::uint32_t prev = nil;
+        std::uint32_t next = nil;
+        std::uint32_t list = nil;
+        std::uint32_t generation = 0;
+    };
+
+    struct overflow_entry {
+        time_type deadline;
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    struct later_deadline {
+        bool operator()( const overflow_entry& lhs, const overflow_entry& rhs ) const {
+            return lhs.deadline > rhs.deadline;
+        }
+    };
+
+    using entry_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<entry>;
+    using index_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+    using overflow_allocator = typename mystd::allocator_traits<Allocator>::template rebind_alloc<overflow_entry>;
+
+    mystd::vector<entry, entry_allocator> entries;
+    mystd::vector<std::uint32_t, index_allocator> heads;
+    mystd::vector<std::uint32_t, index_allocator> free_entries;
+    mystd::array<std::uint64_t, Levels> occupied{};
+    mystd::priority_queue<overflow_entry, mystd::vector<overflow_entry, overflow_allocator>, later_deadline> overflow;
+    batch_type batch;
+    time_type current = 0;
+    size_type sz = 0;
+
+    static handle_type make_handle( std::uint32_t index, std::uint32_t generation ) {
+        return (handle_type(generation) << 32) | index;
+    }
+
+    entry* find( handle_type handle ) {
+        std::uint32_t index = static_cast<std::uint32_t>(handle);
+        if (index >= entries.size()) return nullptr;
+        entry& e = entries[index];
+        if (e.list == nil || e.generation != static_cast<std::uint32_t>(handle >> 32)) return nullptr;
+        return &e;
+    }
+
+    const entry* find( handle_type handle ) const {
+        return const_cast<timing_wheel*>(this)->find(handle);
+    }
+
+    void link( std::uint32_t index, std::uint32_t list ) {
+        entry& e = entries[index];
+        e.list = list;
+        e.prev = nil;
+        e.next = heads[list];
+        if (e.next != nil) entries[e.next].prev = index;
+        heads[list] = index;
+        if (list < expired_list) occupied[list / slots_per_level] |= std::uint64_t(1) << (list % slots_per_level);
+    }
+
+    void unlink( std::uint32_t index ) {
+        entry& e = entries[index];
+        if (e.list == overflow_list) return;
+        if (e.prev != nil) entries[e.prev].next = e.next;
+        else heads[e.list] = e.next;
+        if (e.next != nil) entries[e.next].prev = e.prev;
+        if (heads[e.list] == nil && e.list < expired_list) occupied[e.list / slots_per_level] &= ~(std::uint64_t(1) << (e.list % slots_per_level));
+    }
+
+    // Files the entry relative to current: already due, on the level of its highest differing digit,
+    // or into the overflow queue.
+    void place( std::uint32_t index ) {
+        entry& e = entries[index];
+        if (e.deadline <= current) return link(index, expired_list);
+        std::size_t level = static_cast<std::size_t>(std::bit_width(e.deadline ^ current) - 1) / slot_bits;
+        if (level >= Levels) {
+            e.list = overflow_list;
+            overflow.push(overflow_entry{ e.deadline, index, e.generation });
+            return;
+        }
+        link(index, static_cast<std::uint32_t>(level * slots_per_level + ((e.deadline >> (level * slot_bits)) & (slots_per_level - 1))));
+    }
+
+    std::uint32_t acquire() {
+        if (!free_entries.empty()) {
+            std::uint32_t index = free_entries.back();
+            free_entries.pop_back();
+            return index;
+        }
+        if (entries.size() >= nil) throw std::length_error("timing_wheel");
+        entries.push_back(entry());
+        return static_cast<std::uint32_t>(entries.size() - 1);
+    }
+
+    void release( std::uint32_t index ) {
+        entry& e = entries[index];
+        e.value.reset();
+        e.list = nil;
+        ++e.generation;
+        free_entries.push_back(index);
+        --sz;
+    }
+
+    template< class Arg >
+    handle_type insert( time_type deadline, Arg&& arg ) {
+        std::uint32_t index = acquire();
+        entry& e = entries[index];
+        try { e.value.emplace(std::forward<Arg>(arg)); }
+        catch (...) {
+            free_entries.push_back(index);
+            throw;
+        }
+        e.deadline = deadline;
+        ++sz;
+        place(index);
+        return make_handle(index, e.generation);
+    }
+
+    // Earliest tick after current at which an occupied slot comes due or the overflow window of the
+    // earliest far-future deadline opens. Every occupied slot on a level lies past current's digit there.
+    time_type next_event() const {
+        time_type next = std::numeric_limits<time_type>::max();
+        for (std::size_t level = 0; level < Levels; ++level) {
+            std::size_t shift = level * slot_bits;
+            std::size_t digit = (current >> shift) & (slots_per_level - 1);
+            std::uint64_t ahead = digit + 1 == slots_per_level ? 0 : occupied[level] & (~std::uint64_t(0) << (digit + 1));
+            if (!ahead) continue;
+            time_type at = (current >> (shift + slot_bits) << (shift + slot_bits)) | (time_type(std::countr_zero(ahead)) << shift);
+            if (at < next) next = at;
+        }
+        if (!overflow.empty()) {
+            time_type at = std::max(overflow.top().deadline >> wheel_bits << wheel_bits, current + 1);
+            if (at < next) next = at;
+        }
+        return next;
+    }
+
+    // Called with current on a slot boundary: pulls the overflow records whose window has opened and
+    // redistributes each slot that just came due, from the coarsest level down.
+    void cascade() {
+        while (!overflow.empty() && (overflow.top().deadline >> wheel_bits) <= (current >> wheel_bits)) {
+            overflow_entry record = overflow.pop_value();
+            entry& e = entries[record.index];
+            if (e.list == overflow_list && e.generation == record.generation && e.deadline == record.deadline) place(record.index);
+        }
+        for (std::size_t level = Levels; level-- > 0; ) {
+            std::size_t shift = level * slot_bits;
+            if (current & ((time_type(1) << shift) - 1)) continue;
+            std::uint32_t list = static_cast<std::uint32_t>(level * slots_per_level + ((current >> shift) & (slots_per_level - 1)));
+            std::uint32_t index = heads[list];
+            if (index == nil) continue;
+            heads[list] = nil;
+            occupied[level] &= ~(std::uint64_t(1) << (list % slots_per_level));
+            while (index != nil) {
+                std::uint32_t next = entries[index].next;
+                place(index);
+                index = next;
+            }
+        }
+    }
+
+    template< class Fn >
+    size_type fire( Fn& fn ) {
+        for (std::uint32_t index = heads[expired_list]; index != nil; ) {
+            std::uint32_t next = entries[index].next;
+            batch.push_back(std::move(*entries[index].value));
+            release(index);
+            index = next;
+        }
+        heads[expired_list] = nil;
+        size_type fired = batch.size();
+        if (fired) {
+            fn(batch);
+            batch.clear();
+        }
+        return fired;
+    }
+
+public:
+    explicit timing_wheel( time_type start = 0 ) : heads(Levels * slots_per_level + 1, nil), current(start) {}
+
+    timing_wheel( time_type start, const Allocator& alloc ) : entries(entry_allocator(alloc)), heads(index_allocator(alloc)), free_entries(index_allocator(alloc)), overflow(later_deadline(), mystd::vector<overflow_entry, overflow_allocator>(overflow_allocator(alloc))), batch(alloc), current(start) {
+        heads.assign(Levels * slots_per_level + 1, nil);
+    }
+
+    timing_wheel( const timing_wheel& other ) = default;
+
+    timing_wheel( timing_wheel&& other ) noexcept = default;
+
+    ~timing_wheel() = default;
+
+    timing_wheel& operator=( const timing_wheel& other ) = default;
+
+    timing_wheel& operator=( timing_wheel&& other ) noexcept = default;
+
+    time_type now() const {
+        return current;
+    }
+
+    bool empty() const {
+        return sz == 0;
+    }
+
+    size_type size() const {
+        return sz;
+    }
+
+    bool contains( handle_type handle ) const {
+        return find(handle) != nullptr;
+    }
+
+    time_type deadline( handle_type handle ) const {
+        const entry* e = find(handle);
+        if (!e) throw std::out_of_range("timing_wheel");
+        return e->deadline;
+    }
+
+    // A deadline at or before now() fires on the next call to advance().
+    handle_type schedule( time_type deadline, const value_type& value ) {
+        return insert(deadline, value);
+    }
+
+    handle_type schedule( time_type deadline, value_type&& value ) {
+        return insert(deadline, std::move(value));
+    }
+
+    bool cancel( handle_type handle ) {
+        entry* e = find(handle);
+        if (!e) return false;
+        std::uint32_t index = static_cast<std::uint32_t>(handle);
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    bool reschedule( handle_type handle, time_type deadline ) {
+        entry* e = find(handle);
+        if (!e) return false;
+        std::uint32_t index = static_cast<std::uint32_t>(handle);
+        unlink(index);
+        e->deadline = deadline;
+        place(index);
+        return true;
+    }
+
+    // Moves the clock to now (it never goes backwards) and hands every timer whose deadline has been
+    // reached to fn, one batch per expiry tick in deadline order. fn receives a batch_type& whose
+    // elements it may move from; it may schedule and cancel timers but must not call advance.
+    template< class Fn >
+    requires std::invocable<Fn&, batch_type&>
+    size_type advance( time_type now, Fn fn ) {
+        size_type fired = fire(fn);
+        while (current < now) {
+            time_type next = next_event();
+            if (next > now) {
+                current = now;
+                break;
+            }
+            current = next;
+            cascade();
+            fired += fire(fn);
+        }
+        return fired;
+    }
+
+    batch_type advance( time_type now ) {
+        batch_type expired(batch.get_allocator());
+        advance(now, [&expired]( batch_type& ready ) {
+            for (value_type& value : ready) expired.push_back(std::move(value));
+        });
+        return expired;
+    }
+
+    void clear() {
+        for (std::uint32_t index = 0; index < entries.size(); ++index) {
+            if (entries[index].list != nil) release(index);
+        }
+        for (std::uint32_t& head : heads) head = nil;
+        for (std::uint64_t& word : occupied) word = 0;
+        while (!overflow.empty()) overflow.pop();
+    }
+
+    void swap( timing_wheel& other ) noexcept {
+        entries.swap(other.entries);
+        heads.swap(other.heads);
+        free_entries.swap(other.free_entries);
+        std::swap(occupied, other.occupied);
+        std::swap(overflow, other.overflow);
+        batch.swap(other.batch);
+        std::swap(current, other.current);
+        std::swap(sz, other.sz);
+    }
+};
+
+template< class T, std::size_t Levels, class Allocator >
+requires (Levels > 0 && Levels * 6 < 64)
+struct is_trivially_relocatable<mystd::timing_wheel<T, Levels, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, std::size_t Levels, class Allocator >
+void swap( mystd::timing_wheel<T, Levels, Allocator>& lhs, mystd::timing_wheel<T, Levels, Allocator>& rhs ) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace std
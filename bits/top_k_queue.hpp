@@ -0,0 +1,166 @@
+#pragma once // top_k_queue.hpp
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include "algorithm-heap.hpp"
+#include "is_trivially_relocatable.hpp"
+#include "vector.hpp"
+
+namespace mystd {
+
+// Keeps the k greatest elements (under Compare) seen so far. The kept elements form a heap whose
+// top is the worst of them, the threshold a candidate must beat: a rejected candidate costs one
+// comparison and an accepted one replaces the threshold with a single sift.
+template<class T, class Container = mystd::vector<T>, class Compare = std::less<typename Container::value_type>>
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+class top_k_queue {
+public:
+    using container_type = Container;
+    using value_compare = Compare;
+    using value_type = typename Container::value_type;
+    using size_type = typename Container::size_type;
+    using reference = typename Container::reference;
+    using const_reference = typename Container::const_reference;
+
+protected:
+    struct inverted_compare {
+        Compare comp;
+        bool operator()( const value_type& lhs, const value_type& rhs ) const { return comp(rhs, lhs); }
+    };
+
+    Container c = Container();
+    inverted_compare inv = inverted_compare{ Compare() };
+    size_type k = 0;
+
+public:
+    explicit top_k_queue( size_type count, const Compare& compare = Compare() ) : inv{ compare }, k(count) {
+        c.reserve(k);
+    }
+
+    template< class Alloc >
+    top_k_queue( size_type count, const Compare& compare, const Alloc& alloc ) : c(alloc), inv{ compare }, k(count) {
+        c.reserve(k);
+    }
+
+    top_k_queue( const top_k_queue& other ) = default;
+
+    top_k_queue( top_k_queue&& other ) noexcept = default;
+
+    ~top_k_queue() = default;
+
+    top_k_queue& operator=( const top_k_queue& other ) = default;
+
+    top_k_queue& operator=( top_k_queue&& other ) noexcept = default;
+
+    const_reference threshold() const {
+        return c.front();
+    }
+
+    bool empty() const {
+        return c.empty();
+    }
+
+    bool full() const {
+        return c.size() >= k;
+    }
+
+    size_type size() const {
+        return c.size();
+    }
+
+    size_type capacity() const {
+        return k;
+    }
+
+    value_compare value_comp() const {
+        return inv.comp;
+    }
+
+    bool would_accept( const value_type& value ) const {
+        return c.size() < k || (k > 0 && inv.comp(c.front(), value));
+    }
+
+    bool push( const value_type& value ) {
+        if (c.size() < k) {
+            c.push_back(value);
+            mystd::push_heap(c.begin(), c.end(), inv);
+            return true;
+        }
+        if (!would_accept(value)) return false;
+        replace_top(value);
+        return true;
+    }
+
+    bool push( value_type&& value ) {
+        if (c.size() < k) {
+            c.push_back(std::move(value));
+            mystd::push_heap(c.begin(), c.end(), inv);
+            return true;
+        }
+        if (!would_accept(value)) return false;
+        replace_top(std::move(value));
+        return true;
+    }
+
+    // Overwrites the threshold element with value and restores the heap in one sift.
+    void replace_top( value_type value ) {
+        mystd::__adjust_heap(c.begin(), 0, static_cast<std::ptrdiff_t>(c.size()), std::move(value), inv);
+    }
+
+    // Offers value and returns whatever falls out: the evicted threshold, value itself if it is
+    // rejected, or nothing while the queue is still filling up.
+    std::optional<value_type> push_pop( value_type value ) {
+        if (c.size() < k) {
+            push(std::move(value));
+            return std::nullopt;
+        }
+        if (!would_accept(value)) return std::optional<value_type>(std::move(value));
+        std::optional<value_type> evicted(std::move(c.front()));
+        replace_top(std::move(value));
+        return evicted;
+    }
+
+    void pop() {
+        mystd::pop_heap(c.begin(), c.end(), inv);
+        c.pop_back();
+    }
+
+    // Hands back the kept elements best first and leaves the queue empty with its capacity reserved.
+    Container drain_sorted() {
+        mystd::sort_heap(c.begin(), c.end(), inv);
+        Container result = std::move(c);
+        c = Container(result.get_allocator());
+        c.reserve(k);
+        return result;
+    }
+
+    void clear() {
+        c.clear();
+    }
+
+    void swap( top_k_queue& other ) noexcept( noexcept(std::swap(c, other.c)) && noexcept(std::swap(inv, other.inv)) ) {
+        std::swap(c, other.c);
+        std::swap(inv, other.inv);
+        std::swap(k, other.k);
+    }
+};
+
+template< class T, class Container, class Compare >
+requires std::random_access_iterator<typename Container::iterator> && std::predicate<Compare, const T&, const T&>
+struct is_trivially_relocatable<mystd::top_k_queue<T, Container, Compare>> : std::conjunction<is_trivially_relocatable<Container>, is_trivially_relocatable<Compare>> {};
+
+} // namespace mystd
+
+namespace std {
+
+template< class T, class Container, class Compare >
+void swap( mystd::top_k_queue<T, Container, Compare>& lhs, mystd::top_k_queue<T, Container, Compare>& rhs ) noexcept( noexcept(lhs.swap(rhs)) ) {
+    lhs.swap(rhs);
+}
+
+} // namespace std
@@ -0,0 +1,62 @@
+#pragma once // vector-growth.hpp
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+
+namespace mystd {
+
+// Growth policies for vector. When an insertion needs more room, the vector asks its policy for the
+// new capacity through Growth::grow(size, required, elem_size), where required > size is the element
+// count the insertion needs and elem_size is sizeof the element. The vector never allocates less
+// than required and clamps the result to max_size(), so a policy only has to say how far past
+// required it wants to go.
+
+template<class Growth>
+concept vector_growth_policy = requires(std::size_t n) {
+    { Growth::grow(n, n, n) } -> std::convertible_to<std::size_t>;
+};
+
+// Multiplies the size by Num / Den. 3/2 leaves freed blocks that a later allocation can reuse;
+// 2/1 needs fewer reallocations.
+template<std::size_t Num = 2, std::size_t Den = 1>
+requires (Den > 0 && Num > Den)
+struct geometric_growth {
+    static constexpr std::size_t grow(std::size_t size, std::size_t required, std::size_t) noexcept {
+        std::size_t grown = size > std::numeric_limits<std::size_t>::max() / Num ? std::numeric_limits<std::size_t>::max() : size * Num / Den;
+        return std::max({grown, size + 1, required});
+    }
+};
+
+// Grows by Base, then rounds the block up to the next malloc-style size class (16-byte steps up to
+// 128 bytes, then four classes per power of two), so the slack the allocator would hand out anyway
+// becomes usable capacity.
+template<class Base = geometric_growth<3, 2>>
+struct size_class_growth {
+    static constexpr std::size_t grow(std::size_t size, std::size_t required, std::size_t elem_size) noexcept {
+        std::size_t count = std::max(Base::grow(size, required, elem_size), required);
+        if (count > std::numeric_limits<std::size_t>::max() / 2 / elem_size) return count;
+        std::size_t bytes = std::max<std::size_t>(count * elem_size, 16);
+        std::size_t step = std::max<std::size_t>(std::bit_floor(bytes - 1) / 4, 16);
+        return (bytes + step - 1) / step * step / elem_size;
+    }
+};
+
+// Grows by Base until the buffer reaches ThresholdBytes, then by ThresholdBytes at a time, which
+// bounds the unused tail of very large vectors. Elements larger than ThresholdBytes would make that
+// step less than one element, so vectors of them grow by Base throughout.
+template<std::size_t ThresholdBytes = std::size_t(16) << 20, class Base = geometric_growth<2, 1>>
+requires (ThresholdBytes > 0)
+struct linear_growth {
+    static constexpr std::size_t grow(std::size_t size, std::size_t required, std::size_t elem_size) noexcept {
+        std::size_t step = ThresholdBytes / elem_size;
+        if (step == 0 || size < step) return Base::grow(size, required, elem_size);
+        return std::max(size > std::numeric_limits<std::size_t>::max() - step ? std::numeric_limits<std::size_t>::max() : size + step, required);
+    }
+};
+
+using default_growth = geometric_growth<2, 1>;
+
+} // namespace mystd
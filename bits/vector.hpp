@@ -1,9 +1,5 @@
 #pragma once // vector.hpp
 
-#ifndef _MYSTD_VECTOR_GROW
-#define _MYSTD_VECTOR_GROW 2
-#endif
-
 #include <algorithm>
 #include <compare>
 #include <cstddef>
@@ -13,19 +9,32 @@
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <new>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include "allocator.hpp"
+#include "is_trivially_relocatable.hpp"
 #include "range-access.hpp"
+#include "vector-growth.hpp"
 
 namespace mystd {
 
-template<class T, class Allocator = mystd::allocator<T>>
-requires std::is_same_v<T, typename Allocator::value_type>
+// Tag selecting default- rather than value-initialization of new elements, which leaves trivially
+// default constructible elements (integers, floats, PODs) uninitialized, to be overwritten.
+struct default_init_t {
+    explicit default_init_t() = default;
+};
+
+inline constexpr default_init_t default_init{};
+
+template<class T, class Allocator = mystd::allocator<T>, class Growth = mystd::default_growth>
+requires std::is_same_v<T, typename Allocator::value_type> && mystd::vector_growth_policy<Growth>
 class vector {
 public:
     using value_type = T;
     using allocator_type = Allocator;
+    using growth_policy = Growth;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = T&;
@@ -53,6 +62,48 @@ private:
         cap = 0;
     }
 
+    // Relocates [index, sz) count slots up, leaving raw storage at [index, index + count).
+    constexpr void open_gap(std::size_t index, std::size_t count) noexcept {
+        std::memmove(static_cast<void*>(elems + index + count), static_cast<const void*>(elems + index), (sz - index) * sizeof(T));
+    }
+
+    // Relocates [index + count, sz + count) back down over a gap opened by open_gap.
+    constexpr void close_gap(std::size_t index, std::size_t count) noexcept {
+        std::memmove(static_cast<void*>(elems + index), static_cast<const void*>(elems + index + count), (sz - index) * sizeof(T));
+    }
+
+    // Constructs the elements of a gap opened by open_gap; if one throws, the gap is closed again.
+    template<class Construct>
+    constexpr void fill_gap(std::size_t index, std::size_t count, Construct construct) {
+        open_gap(index, count);
+        T* i = elems + index;
+        try {
+            for (; i != elems + index + count; ++i) construct(i);
+        } catch (...) {
+            for (T* j = elems + index; j != i; ++j) mystd::allocator_traits<Allocator>::destroy(alloc, j);
+            close_gap(index, count);
+            throw;
+        }
+    }
+
+    // Default-initializes [first, first + count), which for trivially default constructible T does nothing.
+    constexpr void default_init_n(T* first, std::size_t count) {
+        if constexpr (!std::is_trivially_default_constructible_v<T>) {
+            T* i = first;
+            try {
+                for (; i != first + count; ++i) ::new (static_cast<void*>(i)) T;
+            } catch (...) {
+                for (T* j = first; j != i; ++j) mystd::allocator_traits<Allocator>::destroy(alloc, j);
+                throw;
+            }
+        }
+    }
+
+    constexpr std::size_t next_capacity(std::size_t required) const {
+        if (required > max_size()) throw std::length_error("vector");
+        return std::min(std::max<std::size_t>(Growth::grow(sz, required, sizeof(T)), required), max_size());
+    }
+
 public:
     constexpr vector() noexcept(noexcept(Allocator())) : alloc(Allocator()), elems(nullptr), sz(0), cap(0) {}
     explicit constexpr vector(const Allocator& alloc_) noexcept : alloc(alloc_), elems(nullptr), sz(0), cap(0) {}
@@ -66,6 +117,19 @@ public:
         }
     }
 
+    vector(std::size_t count, mystd::default_init_t, const Allocator& alloc_ = Allocator()) : alloc(alloc_), elems(nullptr), sz(0), cap(0) {
+        if (count > 0) {
+            elems = mystd::allocator_traits<Allocator>::allocate(alloc, count);
+            cap = count;
+            try { default_init_n(elems, count); }
+            catch (...) {
+                mystd::allocator_traits<Allocator>::deallocate(alloc, elems, cap);
+                throw;
+            }
+            sz = count;
+        }
+    }
+
     constexpr vector(std::size_t count, const T& value, const Allocator& alloc_ = Allocator()) : alloc(alloc_), sz(count), cap(count) {
         if (count == 0) elems = nullptr;
         else {
@@ -334,34 +398,43 @@ public:
     constexpr void reserve(std::size_t new_cap) {
         if (new_cap <= cap) return;
         if (new_cap > max_size()) throw std::length_error("vector");
-        T* new_elems = mystd::allocator_traits<Allocator>::allocate(alloc, new_cap);
-        if (elems) {
-            if constexpr (std::is_trivially_copyable_v<T>) {
-                std::memcpy(new_elems, elems, sz * sizeof(T));
-            } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                T* p = new_elems;
-                try {
-                    for (T* i = elems; i != elems + sz; ++i, ++p)
-                        mystd::allocator_traits<Allocator>::construct(alloc, p, std::move(*i));
-                } catch (...) {
-                    for (T* i = new_elems; i != p; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
-                    mystd::allocator_traits<Allocator>::deallocate(alloc, new_elems, new_cap);
-                    throw;
-                }
-            } else {
-                T* p = new_elems;
-                try {
-                    for (T* i = elems; i != elems + sz; ++i, ++p)
-                        mystd::allocator_traits<Allocator>::construct(alloc, p, *i);
-                } catch (...) {
-                    for (T* i = new_elems; i != p; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
-                    mystd::allocator_traits<Allocator>::deallocate(alloc, new_elems, new_cap);
-                    throw;
+        if (std::size_t count = elems ? mystd::allocator_traits<Allocator>::expand(alloc, elems, cap, new_cap) : 0) {
+            cap = count;
+            return;
+        }
+        if constexpr (mystd::is_trivially_relocatable_v<T>) {
+            auto [new_elems, new_count] = elems ? mystd::allocator_traits<Allocator>::reallocate(alloc, elems, cap, new_cap, sz) : mystd::allocator_traits<Allocator>::allocate_at_least(alloc, new_cap);
+            elems = new_elems;
+            new_cap = new_count;
+        } else {
+            auto [new_elems, new_count] = mystd::allocator_traits<Allocator>::allocate_at_least(alloc, new_cap);
+            new_cap = new_count;
+            if (elems) {
+                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                    T* p = new_elems;
+                    try {
+                        for (T* i = elems; i != elems + sz; ++i, ++p)
+                            mystd::allocator_traits<Allocator>::construct(alloc, p, std::move(*i));
+                    } catch (...) {
+                        for (T* i = new_elems; i != p; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
+                        mystd::allocator_traits<Allocator>::deallocate(alloc, new_elems, new_cap);
+                        throw;
+                    }
+                } else {
+                    T* p = new_elems;
+                    try {
+                        for (T* i = elems; i != elems + sz; ++i, ++p)
+                            mystd::allocator_traits<Allocator>::construct(alloc, p, *i);
+                    } catch (...) {
+                        for (T* i = new_elems; i != p; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
+                        mystd::allocator_traits<Allocator>::deallocate(alloc, new_elems, new_cap);
+                        throw;
+                    }
                 }
+                destroy_deallocate();
             }
-            destroy_deallocate();
+            elems = new_elems;
         }
-        elems = new_elems;
         cap = new_cap;
     }
 
@@ -370,11 +443,13 @@ public:
     constexpr void shrink_to_fit() {
         if (cap != sz) {
             if (sz == 0) destroy_deallocate();
-            else {
+            else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+                auto [new_elems, new_count] = mystd::allocator_traits<Allocator>::reallocate(alloc, elems, cap, sz, sz);
+                elems = new_elems;
+                cap = new_count;
+            } else {
                 T* new_elems = mystd::allocator_traits<Allocator>::allocate(alloc, sz);
-                if constexpr (std::is_trivially_copyable_v<T>) {
-                    std::memcpy(new_elems, elems, sz * sizeof(T));
-                } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
                     T* p = new_elems;
                     try { for (T* i = elems; i != elems + sz; ++i, ++p) mystd::allocator_traits<Allocator>::construct(alloc, p, std::move(*i)); }
                     catch (...) {
@@ -408,11 +483,13 @@ public:
 
     constexpr iterator insert(const_iterator pos, const T& value) {
         std::size_t index = pos - elems;
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if (index < sz) {
             if constexpr (std::is_trivially_copyable_v<T>) {
                 std::memmove(elems + index + 1, elems + index, (sz - index) * sizeof(T));
                 elems[index] = value;
+            } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+                fill_gap(index, 1, [&](T* p) { mystd::allocator_traits<Allocator>::construct(alloc, p, value); });
             } else {
                 mystd::allocator_traits<Allocator>::construct(alloc, elems + sz, std::move(elems[sz - 1]));
                 for (T* i = elems + sz - 1; i != elems + index; --i) *i = std::move(*(i - 1));
@@ -427,11 +504,13 @@ public:
 
     constexpr iterator insert(const_iterator pos, T&& value) {
         std::size_t index = pos - elems;
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if (index < sz) {
             if constexpr (std::is_trivially_copyable_v<T>) {
                 std::memmove(elems + index + 1, elems + index, (sz - index) * sizeof(T));
                 elems[index] = std::move(value);
+            } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+                fill_gap(index, 1, [&](T* p) { mystd::allocator_traits<Allocator>::construct(alloc, p, std::move(value)); });
             } else {
                 mystd::allocator_traits<Allocator>::construct(alloc, elems + sz, std::move(elems[sz - 1]));
                 for (T* i = elems + sz - 1; i != elems + index; --i) *i = std::move(*(i - 1));
@@ -447,10 +526,12 @@ public:
     constexpr iterator insert(const_iterator pos, std::size_t count, const T& value) {
         if (count == 0) return const_cast<iterator>(pos);
         std::size_t index = pos - elems;
-        if (sz + count > cap) reserve(std::max(sz ? sz * _MYSTD_VECTOR_GROW : 1, sz + count));
+        if (sz + count > cap) reserve(next_capacity(sz + count));
         if constexpr (std::is_trivially_copyable_v<T>) {
             std::memmove(elems + index + count, elems + index, (sz - index) * sizeof(T));
             for (T* i = elems + index; i != elems + index + count; ++i) *i = value;
+        } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+            fill_gap(index, count, [&](T* p) { mystd::allocator_traits<Allocator>::construct(alloc, p, value); });
         } else {
             for (T* i = elems + sz + count - 1; i != elems + index + count - 1; --i) {
                 if (i < elems + sz) *i = std::move(*(i - count));
@@ -471,13 +552,15 @@ public:
         if constexpr (std::forward_iterator<InputIt>) {
             std::size_t count = static_cast<std::size_t>(std::distance(first, last));
             if (count == 0) return const_cast<iterator>(pos);
-            if (sz + count > cap) reserve(std::max(sz ? sz * _MYSTD_VECTOR_GROW : 1, sz + count));
+            if (sz + count > cap) reserve(next_capacity(sz + count));
             if constexpr (std::is_trivially_copyable_v<T>) {
                 std::memmove(elems + index + count, elems + index, (sz - index) * sizeof(T));
                 if constexpr (std::contiguous_iterator<InputIt>)
                     std::memmove(elems + index, &*first, count * sizeof(T));
                 else
                     std::copy(first, last, elems + index);
+            } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+                fill_gap(index, count, [&](T* p) { mystd::allocator_traits<Allocator>::construct(alloc, p, *first); ++first; });
             } else {
                 for (T* i = elems + sz + count - 1; i != elems + index + count - 1; --i) {
                     if (i < elems + sz) *i = std::move(*(i - count));
@@ -491,7 +574,7 @@ public:
             sz += count;
             return elems + index;
         } else {
-            vector<T, Allocator> tmp(first, last, alloc);
+            vector tmp(first, last, alloc);
             return insert(pos, tmp.begin(), tmp.end());
         }
     }
@@ -503,7 +586,7 @@ public:
     template<class Arg>
     constexpr iterator emplace(const_iterator pos, Arg&& arg) {
         std::size_t index = pos - elems;
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if (index == sz) {
             if constexpr (std::is_trivially_move_constructible_v<T>)
                 elems[sz] = T(std::forward<Arg>(arg));
@@ -513,6 +596,8 @@ public:
             if constexpr (std::is_trivially_copyable_v<T>) {
                 std::memmove(elems + index + 1, elems + index, (sz - index) * sizeof(T));
                 elems[index] = T(std::forward<Arg>(arg));
+            } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+                fill_gap(index, 1, [&](T* p) { mystd::allocator_traits<Allocator>::construct(alloc, p, std::forward<Arg>(arg)); });
             } else {
                 mystd::allocator_traits<Allocator>::construct(alloc, elems + sz, std::move(elems[sz - 1]));
                 for (T* i = elems + sz - 1; i != elems + index; --i) *i = std::move(*(i - 1));
@@ -527,6 +612,11 @@ public:
         std::size_t index = pos - elems;
         if constexpr (std::is_trivially_copyable_v<T>) {
             std::memmove(elems + index, elems + index + 1, (sz - index - 1) * sizeof(T));
+        } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+            mystd::allocator_traits<Allocator>::destroy(alloc, elems + index);
+            --sz;
+            close_gap(index, 1);
+            return elems + index;
         } else {
             for (T* i = elems + index; i != elems + sz - 1; ++i) *i = std::move(*(i + 1));
             mystd::allocator_traits<Allocator>::destroy(alloc, elems + sz - 1);
@@ -544,6 +634,11 @@ public:
         std::size_t count = end_index - index;
         if constexpr (std::is_trivially_copyable_v<T>) {
             std::memmove(elems + index, elems + index + count, (sz - index - count) * sizeof(T));
+        } else if constexpr (mystd::is_trivially_relocatable_v<T>) {
+            for (T* i = elems + index; i != elems + index + count; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
+            sz -= count;
+            close_gap(index, count);
+            return elems + index;
         } else {
             for (T* i = elems + index; i + count != elems + sz; ++i) *i = std::move(*(i + count));
             for (T* i = elems + sz - count; i != elems + sz; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
@@ -553,7 +648,7 @@ public:
     }
 
     constexpr void push_back(const T& value) {
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if constexpr (std::is_trivially_copyable_v<T>)
             elems[sz++] = value;
         else {
@@ -563,7 +658,7 @@ public:
     }
 
     constexpr void push_back(T&& value) {
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if constexpr (std::is_trivially_move_constructible_v<T>)
             elems[sz++] = std::move(value);
         else {
@@ -574,7 +669,7 @@ public:
 
     template<class Arg>
     constexpr T& emplace_back(Arg&& arg) {
-        if (sz == cap) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
+        if (sz == cap) reserve(next_capacity(sz + 1));
         if constexpr (std::is_trivially_move_constructible_v<T>)
             elems[sz] = T(std::forward<Arg>(arg));
         else
@@ -602,6 +697,29 @@ public:
         }
     }
 
+    // As resize, but new elements are default-initialized: for trivially default constructible T their
+    // contents are indeterminate until written.
+    constexpr void resize_for_overwrite(std::size_t new_size) {
+        if (new_size > cap) reserve(new_size);
+        if (new_size < sz) {
+            if constexpr (!std::is_trivially_copyable_v<T>)
+                for (T* i = elems + new_size; i != elems + sz; ++i) mystd::allocator_traits<Allocator>::destroy(alloc, i);
+            sz = new_size;
+        } else if (new_size > sz) {
+            default_init_n(elems + sz, new_size - sz);
+            sz = new_size;
+        }
+    }
+
+    // Appends count default-initialized elements, growing through the growth policy, and returns them
+    // for the caller to fill, e.g. straight from read() or a decoder.
+    constexpr std::span<T> append_uninitialized(std::size_t count) {
+        if (sz + count > cap) reserve(next_capacity(sz + count));
+        default_init_n(elems + sz, count);
+        sz += count;
+        return std::span<T>(elems + sz - count, count);
+    }
+
     constexpr void resize(std::size_t new_size, const T& value) {
         if (new_size > cap) reserve(new_size);
         if (new_size < sz) {
@@ -625,6 +743,9 @@ public:
     }
 };
 
+template<class T, class Allocator, class Growth>
+struct is_trivially_relocatable<vector<T, Allocator, Growth>> : is_trivially_relocatable<Allocator> {};
+
 
 namespace pmr {
     template<class T>
@@ -633,30 +754,30 @@ namespace pmr {
 
 } // namespace mystd
 
-template<class T, class Allocator>
-constexpr bool operator==(const mystd::vector<T, Allocator>& lhs, const mystd::vector<T, Allocator>& rhs) {
+template<class T, class Allocator, class Growth>
+constexpr bool operator==(const mystd::vector<T, Allocator, Growth>& lhs, const mystd::vector<T, Allocator, Growth>& rhs) {
     if (lhs.size() != rhs.size()) return false;
     return std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template<class T, class Allocator>
-constexpr std::strong_ordering operator<=>(const mystd::vector<T, Allocator>& lhs, const mystd::vector<T, Allocator>& rhs) { return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+template<class T, class Allocator, class Growth>
+constexpr std::strong_ordering operator<=>(const mystd::vector<T, Allocator, Growth>& lhs, const mystd::vector<T, Allocator, Growth>& rhs) { return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
 
 namespace std {
 
-template<class T, class Allocator>
-constexpr void swap(mystd::vector<T, Allocator>& lhs, mystd::vector<T, Allocator>& rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
+template<class T, class Allocator, class Growth>
+constexpr void swap(mystd::vector<T, Allocator, Growth>& lhs, mystd::vector<T, Allocator, Growth>& rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
 
-template<class T, class Allocator, class U>
-constexpr typename mystd::vector<T, Allocator>::size_type erase(mystd::vector<T, Allocator>& c, const U& value) {
+template<class T, class Allocator, class Growth, class U>
+constexpr typename mystd::vector<T, Allocator, Growth>::size_type erase(mystd::vector<T, Allocator, Growth>& c, const U& value) {
     auto it = std::remove(c.begin(), c.end(), value);
     auto count = std::distance(it, c.end());
     c.erase(it, c.end());
     return count;
 }
 
-template<class T, class Allocator, class Pred>
-constexpr typename mystd::vector<T, Allocator>::size_type erase_if(mystd::vector<T, Allocator>& c, Pred pred) {
+template<class T, class Allocator, class Growth, class Pred>
+constexpr typename mystd::vector<T, Allocator, Growth>::size_type erase_if(mystd::vector<T, Allocator, Growth>& c, Pred pred) {
     auto it = std::remove_if(c.begin(), c.end(), pred);
     auto count = std::distance(it, c.end());
     c.erase(it, c.end());
@@ -135,11 +135,12 @@ bool operator==(const _Bit_const_iterator& lhs, const _Bit_iterator& rhs) noexce
 std::strong_ordering operator<=>(const _Bit_const_iterator& lhs, const _Bit_iterator& rhs) noexcept { return lhs <=> static_cast<_Bit_const_iterator>(rhs); }
 
 
-template<class Allocator>
-class vector<bool, Allocator> {
+template<class Allocator, class Growth>
+class vector<bool, Allocator, Growth> {
 public:
     using value_type = bool;
     using allocator_type = Allocator;
+    using growth_policy = Growth;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = _Bit_reference;
@@ -153,7 +154,7 @@ public:
     static constexpr std::size_t word_bit = sizeof(unsigned long long) * CHAR_BIT;
 
 private:
-    vector<unsigned long long, mystd::allocator<unsigned long long>> elems;
+    vector<unsigned long long, mystd::allocator<unsigned long long>, Growth> elems;
     std::size_t sz;
     static constexpr std::size_t word_index(std::size_t pos) noexcept { return pos / word_bit; }
     static constexpr std::size_t bit_index(std::size_t pos) noexcept { return pos % word_bit; }
@@ -501,7 +502,6 @@ public:
     }
 
     constexpr void push_back(const bool& value) {
-        if (sz == capacity()) reserve(sz ? sz * _MYSTD_VECTOR_GROW : 1);
         std::size_t b = bit_index(sz);
         if (b == 0) elems.push_back(0ULL);
         if (value) elems.back() |= 1ULL << b;
@@ -542,7 +542,7 @@ public:
         } else resize(new_size);
     }
 
-    constexpr void swap(vector<bool, Allocator>& other) noexcept(mystd::allocator_traits<Allocator>::propagate_on_container_swap::value || mystd::allocator_traits<Allocator>::is_always_equal::value) {
+    constexpr void swap(vector& other) noexcept(mystd::allocator_traits<Allocator>::propagate_on_container_swap::value || mystd::allocator_traits<Allocator>::is_always_equal::value) {
         elems.swap(other.elems);
         std::swap(sz, other.sz);
     }
@@ -569,9 +569,9 @@ public:
 
 namespace std {
 
-template<class Allocator>
-struct hash<mystd::vector<bool, Allocator>> {
-    std::size_t operator()(const mystd::vector<bool, Allocator>& v) const noexcept {
+template<class Allocator, class Growth>
+struct hash<mystd::vector<bool, Allocator, Growth>> {
+    std::size_t operator()(const mystd::vector<bool, Allocator, Growth>& v) const noexcept {
         std::size_t h = 0xcbf29ce484222325ull;
         constexpr std::size_t prime = 0x100000001b3ull;
         for (auto i : v) {
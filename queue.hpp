@@ -1,2 +1,12 @@
 #pragma once
-#include <bits/priority_queue.hpp>
\ No newline at end of file
+#include <bits/priority_queue.hpp>
+#include <bits/indexed_priority_queue.hpp>
+#include <bits/top_k_queue.hpp>
+#include <bits/minmax_heap.hpp>
+#include <bits/radix_heap.hpp>
+#include <bits/bucket_queue.hpp>
+#include <bits/pairing_heap.hpp>
+#include <bits/multiqueue.hpp>
+#include <bits/timing_wheel.hpp>
+#include <bits/external_priority_queue.hpp>
+#include <bits/keyed_priority_queue.hpp>
\ No newline at end of file